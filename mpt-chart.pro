@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
-SUBDIRS = src test
+SUBDIRS = src test tools
 
 src.file = src/mpt-chart.pro
 test.depends = src
+tools.depends = src
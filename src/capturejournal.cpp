@@ -0,0 +1,150 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "capturejournal.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+
+CaptureJournal::CaptureJournal()
+    : _queue(QueueCapacity)
+{
+
+}
+
+CaptureJournal::~CaptureJournal()
+{
+    close();
+}
+
+bool CaptureJournal::open(const QString &fileName, const QByteArray &header)
+{
+    close();
+
+    // Opening is checked here, writing happens on the writer thread.
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        _errorString = QString("Could not open journal %1: %2")
+                .arg(fileName).arg(file.errorString());
+        return false;
+    }
+    file.close();
+
+    _fileName = fileName;
+    _errorString.clear();
+    _droppedChunks = 0;
+    _stop = false;
+    _failed = false;
+    _thread.reset(QThread::create([this, header] { write(header); }));
+    _thread->setObjectName("CaptureJournal");
+    _thread->start(QThread::LowPriority);
+    return true;
+}
+
+void CaptureJournal::close()
+{
+    if (!_thread)
+        return;
+
+    // Whatever append() held back is written as well, unless writing
+    // failed already; nothing drains the queue then.
+    while (!_spill.isEmpty() && !_failed && !_queue.push(_spill))
+        QThread::msleep(IdleInterval);
+    _spill.clear();
+
+    _stop = true;
+    _thread->wait();
+    _thread.reset();
+}
+
+QString CaptureJournal::errorString() const
+{
+    // The writer thread does not touch _writeError once it failed.
+    return _failed ? _writeError : _errorString;
+}
+
+void CaptureJournal::append(const QByteArray &data)
+{
+    if (!_thread || _failed)
+        return;
+
+    // Held back chunks go first, as one chunk, so the order is kept.
+    if (!_spill.isEmpty() && _queue.push(_spill))
+        _spill.clear();
+    if (_spill.isEmpty() && _queue.push(data))
+        return;
+
+    if (_spill.size() + data.size() >= SpillCapacity) {
+        ++_droppedChunks;
+        return;
+    }
+    if (!_spill.isEmpty())
+        _spill.append('\n');
+    _spill.append(data);
+}
+
+void CaptureJournal::write(const QByteArray &header)
+{
+    QFile file(_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Append)) {
+        _writeError = QString("Could not open journal %1: %2")
+                .arg(_fileName).arg(file.errorString());
+        _failed = true;
+        return;
+    }
+
+    QByteArray batch;
+    batch.reserve(2 * BatchSize);
+    batch.append(header);
+    QElapsedTimer flushed;
+    flushed.start();
+
+    QByteArray data;
+    auto separate = !header.isEmpty();
+    forever {
+        // Read the flag first, so nothing appended before close() is lost.
+        auto stop = _stop.load();
+        auto idle = true;
+        while (batch.size() < BatchSize && _queue.pop(data)) {
+            if (separate)
+                batch.append('\n');
+            batch.append(data);
+            separate = true;
+            idle = false;
+        }
+
+        if (!batch.isEmpty() && (batch.size() >= BatchSize || stop ||
+                                 flushed.elapsed() >= FlushInterval)) {
+            if (file.write(batch) != batch.size() || !file.flush()) {
+                _writeError = QString("Could not write journal %1: %2")
+                        .arg(_fileName).arg(file.errorString());
+                _failed = true;
+                return;
+            }
+            batch.resize(0);
+            flushed.restart();
+        }
+        if (stop && _queue.isEmpty())
+            break;
+        if (idle)
+            QThread::msleep(IdleInterval);
+    }
+}
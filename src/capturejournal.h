@@ -0,0 +1,122 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CAPTUREJOURNAL_H
+#define CAPTUREJOURNAL_H
+
+#include "spscqueue.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+/**
+ * @brief Append-only file of the raw serial data of a live session.
+ *
+ * append() only queues the data; a writer thread of its own collects it
+ * into batches, writes them and flushes the file at least every
+ * FlushInterval ms. Neither the caller nor the acquisition thread ever
+ * wait for the disk, and a crash loses at most the last FlushInterval ms.
+ * While the queue is full, append() holds the data back in a buffer of up
+ * to SpillCapacity bytes; only beyond that it is dropped.
+ *
+ * The file is a valid CSV file at any time: the header, if any, and every
+ * appended chunk, separated by line breaks.
+ */
+class CaptureJournal final
+{
+public:
+    CaptureJournal();
+    ~CaptureJournal();
+
+    bool open(const QString &fileName, const QByteArray &header = QByteArray());
+
+    /**
+     * @brief Writes everything still queued and closes the file.
+     *
+     * Returns at once if writing failed; the file is incomplete then.
+     */
+    void close();
+
+    bool isOpen() const {
+        return _thread != nullptr;
+    }
+
+    /**
+     * @brief Called by a single producer thread; never blocks.
+     */
+    void append(const QByteArray &data);
+
+    QString fileName() const {
+        return _fileName;
+    }
+
+    /**
+     * @brief Whether the writer thread could not open or write the file;
+     *        everything appended since is lost.
+     */
+    bool hasFailed() const {
+        return _failed;
+    }
+
+    QString errorString() const;
+
+    /**
+     * @brief Chunks lost because the writer fell behind by more than
+     *        SpillCapacity bytes; the file has gaps then.
+     */
+    quint64 droppedChunks() const {
+        return _droppedChunks;
+    }
+
+private:
+    static const int QueueCapacity = 1 << 12;
+    static const int BatchSize = 1 << 16;
+    static const int FlushInterval = 500;
+    static const int IdleInterval = 20;
+    static const int SpillCapacity = 64 * 1024 * 1024;
+
+    void write(const QByteArray &header);
+
+    QString _fileName;
+    QString _errorString;
+
+    /**
+     * @brief Set by the writer thread right before it sets _failed.
+     */
+    QString _writeError;
+    std::unique_ptr<QThread> _thread;
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _failed{false};
+    std::atomic<quint64> _droppedChunks{0};
+    SpscQueue<QByteArray> _queue;
+
+    /**
+     * @brief Chunks of the producer that did not fit into the queue, in
+     *        order and separated by line breaks.
+     */
+    QByteArray _spill;
+};
+
+#endif // CAPTUREJOURNAL_H
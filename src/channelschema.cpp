@@ -0,0 +1,68 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "channelschema.h"
+#include "sample.h"
+
+namespace {
+
+const char TimeColumn[] = "ms";
+const char SyncColumn[] = "sync";
+
+} // namespace
+
+ChannelSchema::ChannelSchema()
+    : _names({ "air1", "air2", "air3", "pulse" })
+{
+
+}
+
+ChannelSchema::ChannelSchema(const QStringList &names)
+    : _names(names)
+{
+
+}
+
+bool ChannelSchema::fromHeader(const char *begin, const char *end, ChannelSchema &schema)
+{
+    auto columns = QByteArray::fromRawData(begin, static_cast<int>(end - begin)).split(',');
+    if (columns.size() < 3 || columns.size() > 2 + Sample::MaxChannels ||
+            columns[0].trimmed() != TimeColumn || columns[1].trimmed() != SyncColumn)
+        return false;
+
+    QStringList names;
+    for (int i=2; i<columns.size(); ++i) {
+        auto name = columns[i].trimmed();
+        if (name.isEmpty())
+            return false;
+        names.append(QString::fromUtf8(name));
+    }
+    schema._names = names;
+    return true;
+}
+
+QByteArray ChannelSchema::header() const
+{
+    QByteArray header(TimeColumn);
+    header.append(',').append(SyncColumn);
+    for (auto &name: _names)
+        header.append(',').append(name.toUtf8());
+    return header;
+}
@@ -0,0 +1,82 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CHANNELSCHEMA_H
+#define CHANNELSCHEMA_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The channels of a recording or device, i.e. the columns of its
+ *        CSV header "ms,sync,<channel>,...".
+ *
+ * The first two columns are always the time and the sync flag; they are
+ * followed by one to Sample::MaxChannels named channels. A default
+ * constructed schema is the one of the original board, which sends
+ * air1, air2, air3 and pulse without announcing them.
+ */
+class ChannelSchema final
+{
+public:
+    ChannelSchema();
+    explicit ChannelSchema(const QStringList &names);
+
+    /**
+     * @brief Parses the header line in [begin, end); returns false and
+     *        leaves schema untouched if it is not a valid header.
+     */
+    static bool fromHeader(const char *begin, const char *end, ChannelSchema &schema);
+
+    int count() const {
+        return _names.size();
+    }
+
+    QString name(int channel) const {
+        return _names[channel];
+    }
+
+    const QStringList& names() const {
+        return _names;
+    }
+
+    int indexOf(const QString &name) const {
+        return _names.indexOf(name);
+    }
+
+    /**
+     * @brief The CSV header line without line break.
+     */
+    QByteArray header() const;
+
+    bool operator==(const ChannelSchema &other) const {
+        return _names == other._names;
+    }
+
+    bool operator!=(const ChannelSchema &other) const {
+        return !(*this == other);
+    }
+
+private:
+    QStringList _names;
+};
+
+#endif // CHANNELSCHEMA_H
@@ -0,0 +1,145 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CHANNELVIEW_H
+#define CHANNELVIEW_H
+
+#include <QPointF>
+#include <QVector>
+
+#include <algorithm>
+
+/**
+ * @brief Read-only view of one channel: a time column and a value column.
+ *
+ * The channels of a SampleStore share its time column and keep their
+ * values as float, which holds every ADC value exactly. The points are
+ * assembled on access, so all algorithms see the same values the chart
+ * gets.
+ */
+class ChannelView
+{
+public:
+    ChannelView() {}
+
+    ChannelView(const qreal *x, const float *y, int size)
+        : _x(x)
+        , _y(y)
+        , _size(size)
+    {
+
+    }
+
+    int size() const {
+        return _size;
+    }
+
+    bool isEmpty() const {
+        return _size == 0;
+    }
+
+    const qreal* x() const {
+        return _x;
+    }
+
+    const float* y() const {
+        return _y;
+    }
+
+    QPointF operator[](int i) const {
+        return QPointF(_x[i], qreal(_y[i]));
+    }
+
+    QPointF first() const {
+        return (*this)[0];
+    }
+
+    QPointF last() const {
+        return (*this)[_size-1];
+    }
+
+    /**
+     * @brief Index of the first sample at or after x.
+     */
+    int lowerBound(qreal x) const {
+        return static_cast<int>(std::lower_bound(_x, _x + _size, x) - _x);
+    }
+
+    /**
+     * @brief Index of the first sample after x.
+     */
+    int upperBound(qreal x) const {
+        return static_cast<int>(std::upper_bound(_x, _x + _size, x) - _x);
+    }
+
+private:
+    const qreal *_x = nullptr;
+    const float *_y = nullptr;
+    int _size = 0;
+};
+
+/**
+ * @brief Owns the columns of a single channel, e.g. of samples paged in
+ *        from a session file.
+ */
+class ChannelBuffer
+{
+public:
+    ChannelBuffer() {}
+
+    explicit ChannelBuffer(const QVector<QPointF> &points) {
+        reserve(points.size());
+        for (auto &point: points)
+            append(point.x(), point.y());
+    }
+
+    void clear() {
+        _x.clear();
+        _y.clear();
+    }
+
+    void reserve(int size) {
+        _x.reserve(size);
+        _y.reserve(size);
+    }
+
+    int size() const {
+        return _x.size();
+    }
+
+    void append(qreal x, qreal y) {
+        _x.append(x);
+        _y.append(static_cast<float>(y));
+    }
+
+    ChannelView view() const {
+        return ChannelView(_x.constData(), _y.constData(), _x.size());
+    }
+
+    operator ChannelView() const {
+        return view();
+    }
+
+private:
+    QVector<qreal> _x;
+    QVector<float> _y;
+};
+
+#endif // CHANNELVIEW_H
@@ -19,7 +19,10 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "chartview.h"
+#include "pipelinestats.h"
+#include "rasterplotitem.h"
 
+#include <QElapsedTimer>
 #include <QValueAxis>
 
 ChartView::ChartView(QWidget *parent)
@@ -29,6 +32,8 @@ ChartView::ChartView(QWidget *parent)
 {
     chart()->addAxis(_axisX, Qt::AlignBottom);
     chart()->addAxis(_axisY, Qt::AlignLeft);
+    _rasterItem = new RasterPlotItem(chart(), _axisX, _axisY);
+    _rasterItem->hide();
     setRubberBand(QChartView::RectangleRubberBand);
 }
 
@@ -42,7 +47,35 @@ QValueAxis* ChartView::axisY() const
     return _axisY;
 }
 
+RasterPlotItem* ChartView::rasterItem() const
+{
+    return _rasterItem;
+}
+
+bool ChartView::isFollowing() const
+{
+    return _rasterItem->isScrolling();
+}
+
+void ChartView::setFollowing(bool following)
+{
+    _rasterItem->setScrolling(following);
+}
+
+void ChartView::setStats(PipelineStats *stats)
+{
+    _stats = stats;
+}
+
 bool ChartView::viewportEvent(QEvent *event)
 {
-    return QChartView::viewportEvent(event);
+    if (event->type() != QEvent::Paint)
+        return QChartView::viewportEvent(event);
+
+    PipelineStats::Tick paint(_stats, PipelineStats::Paint);
+    QElapsedTimer cost;
+    cost.start();
+    auto result = QChartView::viewportEvent(event);
+    emit painted(cost.nsecsElapsed() / 1e6);
+    return result;
 }
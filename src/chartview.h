@@ -29,6 +29,9 @@ QT_CHARTS_END_NAMESPACE
 
 QT_CHARTS_USE_NAMESPACE
 
+class PipelineStats;
+class RasterPlotItem;
+
 class ChartView
         : public QChartView
 {
@@ -40,15 +43,43 @@ public:
     QValueAxis* axisX() const;
     QValueAxis* axisY() const;
 
+    /**
+     * @brief Item drawing the channels in place of their series; hidden
+     *        unless SerialReader is told to use it.
+     */
+    RasterPlotItem* rasterItem() const;
+
+    bool isFollowing() const;
+
+    /**
+     * @brief Lets the raster item scroll what it has drawn along with the
+     *        x axis and draw only the exposed strip.
+     */
+    void setFollowing(bool following);
+
+    /**
+     * @brief Records every paint of the chart as a tick of
+     *        PipelineStats::Paint.
+     */
+    void setStats(PipelineStats *stats);
+
 signals:
     void axisValuesChanged();
 
+    /**
+     * @brief The chart was painted in cost ms, with whatever the series
+     *        held by then.
+     */
+    void painted(qreal cost);
+
 protected:
     bool viewportEvent(QEvent *event) override;
 
 private:
     QValueAxis *_axisX;
     QValueAxis *_axisY;
+    RasterPlotItem *_rasterItem;
+    PipelineStats *_stats = nullptr;
 };
 
 #endif // CHARTVIEW_H
@@ -0,0 +1,179 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "csvparser.h"
+
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Exactly representable powers of ten.
+const qreal Powers[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const int MaxPower = sizeof(Powers) / sizeof(Powers[0]) - 1;
+
+// Parses one field, which must be followed by the separator or the end of
+// the line, and returns the beginning of the next field or nullptr.
+template <typename T, typename Convert>
+const char* field(const char *begin, const char *end, bool last,
+                  T &value, Convert convert)
+{
+    while (begin < end && isSpace(*begin))
+        ++begin;
+    auto next = convert(begin, end, value);
+    if (next == begin)
+        return nullptr;
+    while (next < end && isSpace(*next))
+        ++next;
+    if (last)
+        return next == end ? next : nullptr;
+    if (next == end || *next != ',')
+        return nullptr;
+    return next + 1;
+}
+
+} // namespace
+
+CsvParser::CsvParser()
+{
+
+}
+
+bool CsvParser::parse(const char *begin, const char *end, int channels, Sample &sample)
+{
+    qreal ms;
+    int sync;
+    int values[Sample::MaxChannels];
+    auto next = field(begin, end, false, ms, toDouble);
+    if (next)
+        next = field(next, end, false, sync, toInt);
+    for (int i=0; i<channels && next; ++i)
+        next = field(next, end, i == channels-1, values[i], toInt);
+    if (!next)
+        return false;
+    sample.ms = ms;
+    sample.sync = sync;
+    std::copy(values, values + channels, sample.values);
+    return true;
+}
+
+const char* CsvParser::toInt(const char *begin, const char *end, int &value)
+{
+    auto p = begin;
+    auto negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+'))
+        ++p;
+    if (p == end || !isDigit(*p))
+        return begin;
+
+    // Accumulate negatively, so INT_MIN does not overflow.
+    const qint64 limit = negative ? qint64(std::numeric_limits<int>::min())
+                                  : -qint64(std::numeric_limits<int>::max());
+    qint64 result = 0;
+    for (; p < end && isDigit(*p); ++p) {
+        result = result * 10 - (*p - '0');
+        if (result < limit)
+            return begin;
+    }
+    value = static_cast<int>(negative ? result : -result);
+    return p;
+}
+
+const char* CsvParser::toDouble(const char *begin, const char *end, qreal &value)
+{
+    auto p = begin;
+    auto negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+'))
+        ++p;
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p < end && isDigit(*p); ++p) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if (mantissa)
+                ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && isDigit(*p); ++p) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + quint64(*p - '0');
+                if (mantissa)
+                    ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (!any)
+        return begin;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        auto q = p + 1;
+        int sign = 1;
+        if (q < end && (*q == '-' || *q == '+')) {
+            sign = *q == '-' ? -1 : 1;
+            ++q;
+        }
+        if (q < end && isDigit(*q)) {
+            int e = 0;
+            for (; q < end && isDigit(*q); ++q) {
+                if (e < 10000)
+                    e = e * 10 + (*q - '0');
+            }
+            exponent += sign * e;
+            p = q;
+        }
+    }
+
+    // Mantissa and power of ten are both exact below 2^53 and 10^22, so the
+    // single multiplication or division rounds correctly. Anything else is
+    // beyond what the Arduino sends and only approximated.
+    auto result = qreal(mantissa);
+    if (mantissa < (quint64(1) << 53) && exponent >= -MaxPower && exponent <= MaxPower)
+        result = exponent < 0 ? result / Powers[-exponent] : result * Powers[exponent];
+    else if (mantissa != 0)
+        result *= qPow(10.0, exponent);
+    value = negative ? -result : result;
+    return p;
+}
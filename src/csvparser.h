@@ -0,0 +1,96 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CSVPARSER_H
+#define CSVPARSER_H
+
+#include "sample.h"
+
+#include <QtGlobal>
+
+#include <cstring>
+
+/**
+ * @brief Parses the Arduino CSV output in place.
+ *
+ * Lines and fields are only delimited by pointers into the caller's buffer
+ * and the numbers are converted directly from those ranges, so parsing
+ * never allocates. Like QByteArray::toInt() and toDouble() surrounding
+ * whitespace, including the '\r' of "\r\n" line endings, is accepted.
+ */
+class CsvParser final
+{
+private:
+    CsvParser();
+
+public:
+    /**
+     * @brief Calls function(lineBegin, lineEnd) for every line in
+     *        [begin, end) that is terminated by '\n'.
+     *
+     * Returns the beginning of the unterminated rest, which is end if the
+     * data ends with a complete line.
+     */
+    template <typename Function>
+    static const char* forEachLine(const char *begin, const char *end,
+                                   Function function);
+
+    /**
+     * @brief Parses the row in [begin, end); returns false if it does not
+     *        consist of exactly ms, sync and channels valid numbers.
+     *
+     * sample is only written on success; its values past channels are left
+     * as they were.
+     */
+    static bool parse(const char *begin, const char *end, int channels, Sample &sample);
+
+    /**
+     * @brief Converts [begin, end) into an int in the way of std::from_chars.
+     *
+     * Returns the first character not converted, or begin on failure.
+     */
+    static const char* toInt(const char *begin, const char *end, int &value);
+
+    /**
+     * @brief Converts a decimal number in [begin, end) into a qreal in the
+     *        way of std::from_chars.
+     *
+     * Numbers with up to 15 significant digits and a small exponent, i.e.
+     * everything the Arduino sends, are converted exactly. Returns the
+     * first character not converted, or begin on failure.
+     */
+    static const char* toDouble(const char *begin, const char *end, qreal &value);
+};
+
+template <typename Function>
+const char* CsvParser::forEachLine(const char *begin, const char *end,
+                                   Function function)
+{
+    while (begin < end) {
+        auto newline = static_cast<const char*>(memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        if (!newline)
+            break;
+        function(begin, newline);
+        begin = newline + 1;
+    }
+    return begin;
+}
+
+#endif // CSVPARSER_H
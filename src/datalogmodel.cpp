@@ -0,0 +1,179 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "datalogmodel.h"
+
+#include <cstring>
+
+DataLogModel::DataLogModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+
+}
+
+void DataLogModel::clear()
+{
+    beginResetModel();
+    _data.clear();
+    _available = 0;
+    _lines = 0;
+    _tail = 0;
+    _checkpoints.clear();
+    endResetModel();
+}
+
+void DataLogModel::reserve(int size)
+{
+    _data.reserve(size);
+}
+
+void DataLogModel::setRawData(const QByteArray &data, int available)
+{
+    beginResetModel();
+    _data = data;
+    _available = 0;
+    _lines = 0;
+    _tail = 0;
+    _checkpoints.clear();
+    endResetModel();
+
+    setAvailable(available);
+}
+
+void DataLogModel::setAvailable(int available)
+{
+    available = qMin(available, _data.size());
+    if (available <= _available)
+        return;
+
+    auto oldRows = rows();
+    auto tailRow = _lines;
+    auto begin = _data.constData();
+
+    // Only the new bytes are scanned; the unterminated tail is scanned
+    // again since it may have been continued.
+    while (_tail < available) {
+        auto newline = static_cast<const char*>(memchr(begin + _tail, '\n',
+                                                       static_cast<size_t>(available - _tail)));
+        if (!newline)
+            break;
+        if (lineEnd(_tail, static_cast<int>(newline - begin)) > _tail) {
+            if (_lines % CheckpointInterval == 0)
+                _checkpoints.append(_tail);
+            ++_lines;
+        }
+        _tail = static_cast<int>(newline - begin) + 1;
+    }
+    _available = available;
+
+    auto newRows = rows();
+    if (tailRow < oldRows) {
+        auto index = createIndex(tailRow, 0);
+        emit dataChanged(index, index);
+    }
+    if (newRows > oldRows) {
+        beginInsertRows(QModelIndex(), oldRows, newRows - 1);
+        endInsertRows();
+    }
+}
+
+void DataLogModel::append(const QByteArray &lines)
+{
+    _data.append('\n');
+    _data.append(lines);
+    setAvailable(_data.size());
+    if (_maximumSize > 0 && _data.size() > _maximumSize)
+        dropOldest();
+}
+
+QByteArray DataLogModel::line(int row) const
+{
+    if (row < 0 || row >= rows())
+        return QByteArray();
+
+    if (row == _lines)
+        return _data.mid(_tail, lineEnd(_tail, _available) - _tail);
+
+    // Scan forward from the checkpoint; every line up to _tail is complete.
+    auto begin = _data.constData();
+    auto start = _checkpoints[row / CheckpointInterval];
+    auto skip = row % CheckpointInterval;
+    forever {
+        auto newline = static_cast<const char*>(memchr(begin + start, '\n',
+                                                       static_cast<size_t>(_tail - start)));
+        auto end = lineEnd(start, static_cast<int>(newline - begin));
+        if (end > start) {
+            if (skip == 0)
+                return _data.mid(start, end - start);
+            --skip;
+        }
+        start = static_cast<int>(newline - begin) + 1;
+    }
+}
+
+void DataLogModel::dropOldest()
+{
+    // Whole checkpoint intervals are dropped until half of the maximum size
+    // is left; the remaining checkpoints only have to be shifted.
+    int intervals = 0;
+    while (intervals + 1 < _checkpoints.size() &&
+           _data.size() - _checkpoints[intervals] > _maximumSize / 2)
+        ++intervals;
+    if (intervals == 0)
+        return;
+
+    auto cut = _checkpoints[intervals];
+    auto rows = intervals * CheckpointInterval;
+    beginRemoveRows(QModelIndex(), 0, rows - 1);
+    _data.remove(0, cut);
+    _checkpoints.remove(0, intervals);
+    for (auto &checkpoint: _checkpoints)
+        checkpoint -= cut;
+    _available -= cut;
+    _tail -= cut;
+    _lines -= rows;
+    endRemoveRows();
+}
+
+int DataLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return rows();
+}
+
+QVariant DataLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+    return QString::fromLatin1(line(index.row()));
+}
+
+int DataLogModel::lineEnd(int start, int end) const
+{
+    while (end > start && _data[end - 1] == '\r')
+        --end;
+    return end;
+}
+
+int DataLogModel::rows() const
+{
+    return _lines + (lineEnd(_tail, _available) > _tail ? 1 : 0);
+}
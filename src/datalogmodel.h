@@ -0,0 +1,95 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DATALOGMODEL_H
+#define DATALOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief The raw CSV lines as a list model for the data tab.
+ *
+ * Rows are read lazily from the raw bytes and only formatted when a view
+ * asks for them. Instead of the offset of every line only the offset of
+ * every CheckpointInterval-th line is kept; a row is found by scanning
+ * forward from its checkpoint. Empty lines are not shown.
+ *
+ * Appended data can be limited to a maximum size; the oldest rows are
+ * dropped once it is exceeded, so a live session keeps a bounded tail.
+ */
+class DataLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit DataLogModel(QObject *parent = nullptr);
+
+    const QByteArray& rawData() const {
+        return _data;
+    }
+
+    void clear();
+    void reserve(int size);
+
+    /**
+     * @brief Limits the bytes kept by append(); 0 means no limit.
+     */
+    void setMaximumSize(int size) {
+        _maximumSize = size;
+    }
+
+    /**
+     * @brief Shows data, e.g. a mapped file; only the first available
+     *        bytes are indexed until setAvailable() is called.
+     */
+    void setRawData(const QByteArray &data, int available);
+    void setAvailable(int available);
+
+    /**
+     * @brief Appends lines after a line break.
+     */
+    void append(const QByteArray &lines);
+
+    QByteArray line(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    static const int CheckpointInterval = 64;
+
+    // End of the line [start, end) without a trailing '\r'.
+    int lineEnd(int start, int end) const;
+    int rows() const;
+    void dropOldest();
+
+    QByteArray _data;
+    int _available = 0;
+    int _maximumSize = 0;
+
+    // Complete, i.e. '\n' terminated, non-empty lines before _tail.
+    int _lines = 0;
+    int _tail = 0;
+    QVector<int> _checkpoints;
+};
+
+#endif // DATALOGMODEL_H
@@ -0,0 +1,111 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "datalogview.h"
+
+#include <QAbstractItemModel>
+#include <QPainter>
+#include <QScrollBar>
+
+DataLogView::DataLogView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(1);
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        _followTail = value == verticalScrollBar()->maximum();
+    });
+}
+
+void DataLogView::setModel(QAbstractItemModel *model)
+{
+    if (_model)
+        disconnect(_model, nullptr, this, nullptr);
+    _model = model;
+    if (_model) {
+        connect(_model, &QAbstractItemModel::rowsInserted, this, &DataLogView::rowsChanged);
+        connect(_model, &QAbstractItemModel::rowsRemoved, this, &DataLogView::rowsChanged);
+        connect(_model, &QAbstractItemModel::modelReset, this, &DataLogView::rowsChanged);
+        connect(_model, &QAbstractItemModel::dataChanged, viewport(), QOverload<>::of(&QWidget::update));
+    }
+    rowsChanged();
+}
+
+void DataLogView::setFollowTail(bool follow)
+{
+    _followTail = follow;
+    if (_followTail)
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void DataLogView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    if (!_model)
+        return;
+
+    QPainter painter(viewport());
+    painter.setPen(palette().color(QPalette::Text));
+
+    auto lineHeight = fontMetrics().height();
+    auto margin = fontMetrics().averageCharWidth() / 2;
+    auto first = verticalScrollBar()->value();
+    auto last = qMin(first + visibleRows() + 1, _model->rowCount());
+    for (int row=first; row<last; ++row) {
+        auto text = _model->index(row, 0).data().toString();
+        auto y = (row - first) * lineHeight;
+        painter.drawText(margin, y + fontMetrics().ascent(), text);
+    }
+}
+
+void DataLogView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    rowsChanged();
+}
+
+void DataLogView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+    viewport()->update();
+}
+
+void DataLogView::rowsChanged()
+{
+    auto follow = _followTail;
+    updateScrollBar();
+    setFollowTail(follow);
+    viewport()->update();
+}
+
+void DataLogView::updateScrollBar()
+{
+    auto rows = _model ? _model->rowCount() : 0;
+    auto page = visibleRows();
+    verticalScrollBar()->setPageStep(page);
+    verticalScrollBar()->setRange(0, qMax(0, rows - page));
+}
+
+int DataLogView::visibleRows() const
+{
+    return qMax(1, viewport()->height() / fontMetrics().height());
+}
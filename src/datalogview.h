@@ -0,0 +1,70 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DATALOGVIEW_H
+#define DATALOGVIEW_H
+
+#include <QAbstractScrollArea>
+
+class QAbstractItemModel;
+
+/**
+ * @brief Shows the rows of a list model as plain text lines.
+ *
+ * Only the visible rows are fetched from the model and painted; unlike
+ * QListView no per-row layout is kept, so the view's memory does not
+ * depend on the number of rows. While the view is scrolled to the end it
+ * follows new rows; scrolling up pauses following until the end is
+ * reached again.
+ */
+class DataLogView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit DataLogView(QWidget *parent = nullptr);
+
+    QAbstractItemModel* model() const {
+        return _model;
+    }
+
+    void setModel(QAbstractItemModel *model);
+
+    bool followTail() const {
+        return _followTail;
+    }
+
+    void setFollowTail(bool follow);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    void rowsChanged();
+    void updateScrollBar();
+    int visibleRows() const;
+
+    QAbstractItemModel *_model = nullptr;
+    bool _followTail = true;
+};
+
+#endif // DATALOGVIEW_H
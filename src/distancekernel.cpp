@@ -0,0 +1,288 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "distancekernel.h"
+
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define MPT_KERNEL_X86
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define MPT_TARGET_AVX2
+#  else
+#    define MPT_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#endif
+
+namespace {
+
+using Kernel = int (*)(const double *x, const float *y, int count, double sx,
+                       double sy, double dx, double dy, double &maxCross);
+
+// All kernels compute the cross product of the line direction and the
+// vector from start to the point; its square divided by the squared length
+// of the direction is the squared perpendicular distance. The values are
+// widened to double before anything is computed, so all kernels agree.
+// The scalar kernel also takes x as float, for Qt built with -qreal float.
+template<typename X>
+int farthestScalar(const X *x, const float *y, int count, double sx,
+                   double sy, double dx, double dy, double &maxCross)
+{
+    int index = 0;
+    maxCross = -1.0;
+    for (int i=0; i<count; ++i) {
+        auto cross = dx * (double(y[i]) - sy) - dy * (double(x[i]) - sx);
+        cross *= cross;
+        if (cross > maxCross) {
+            maxCross = cross;
+            index = i;
+        }
+    }
+    return index;
+}
+
+#ifdef MPT_KERNEL_X86
+// Picks the lane with the largest value and, among equal values, the
+// smallest index. Every lane holds the first index of its own maximum.
+int reduce(const double *values, const double *indices, int lanes,
+           double &maxCross)
+{
+    int lane = 0;
+    for (int i=1; i<lanes; ++i) {
+        if (values[i] > values[lane] ||
+                (values[i] == values[lane] && indices[i] < indices[lane]))
+            lane = i;
+    }
+    maxCross = values[lane];
+    return static_cast<int>(indices[lane]);
+}
+
+// The vector kernels keep two independent maxima so consecutive iterations
+// do not wait for the compare and blend of the previous one.
+int farthestSse2(const double *x, const float *y, int count, double sx,
+                 double sy, double dx, double dy, double &maxCross)
+{
+    auto vsx = _mm_set1_pd(sx);
+    auto vsy = _mm_set1_pd(sy);
+    auto vdx = _mm_set1_pd(dx);
+    auto vdy = _mm_set1_pd(dy);
+    auto step = _mm_set1_pd(4.0);
+    __m128d index[2] = { _mm_set_pd(1.0, 0.0), _mm_set_pd(3.0, 2.0) };
+    __m128d maxIndex[2] = { index[0], index[1] };
+    __m128d maxValue[2] = { _mm_set1_pd(-1.0), _mm_set1_pd(-1.0) };
+
+    int i = 0;
+    for (; i+4<=count; i+=4) {
+        auto y4 = _mm_loadu_ps(y + i);
+        __m128d ys[2] = { _mm_cvtps_pd(y4), _mm_cvtps_pd(_mm_movehl_ps(y4, y4)) };
+        for (int k=0; k<2; ++k) {
+            auto px = _mm_sub_pd(_mm_loadu_pd(x + i + 2*k), vsx);
+            auto py = _mm_sub_pd(ys[k], vsy);
+            auto cross = _mm_sub_pd(_mm_mul_pd(vdx, py), _mm_mul_pd(vdy, px));
+            cross = _mm_mul_pd(cross, cross);
+            auto greater = _mm_cmpgt_pd(cross, maxValue[k]);
+            maxValue[k] = _mm_or_pd(_mm_and_pd(greater, cross),
+                                    _mm_andnot_pd(greater, maxValue[k]));
+            maxIndex[k] = _mm_or_pd(_mm_and_pd(greater, index[k]),
+                                    _mm_andnot_pd(greater, maxIndex[k]));
+            index[k] = _mm_add_pd(index[k], step);
+        }
+    }
+
+    alignas(16) double values[4];
+    alignas(16) double indices[4];
+    _mm_store_pd(values, maxValue[0]);
+    _mm_store_pd(values + 2, maxValue[1]);
+    _mm_store_pd(indices, maxIndex[0]);
+    _mm_store_pd(indices + 2, maxIndex[1]);
+    auto result = reduce(values, indices, 4, maxCross);
+
+    if (i < count) {
+        double tailCross;
+        auto tail = farthestScalar(x + i, y + i, count - i, sx, sy, dx, dy, tailCross);
+        if (tailCross > maxCross) {
+            maxCross = tailCross;
+            result = i + tail;
+        }
+    }
+    return result;
+}
+
+MPT_TARGET_AVX2
+int farthestAvx2(const double *x, const float *y, int count, double sx,
+                 double sy, double dx, double dy, double &maxCross)
+{
+    auto vsx = _mm256_set1_pd(sx);
+    auto vsy = _mm256_set1_pd(sy);
+    auto vdx = _mm256_set1_pd(dx);
+    auto vdy = _mm256_set1_pd(dy);
+    auto step = _mm256_set1_pd(8.0);
+    __m256d index[2] = { _mm256_set_pd(3.0, 2.0, 1.0, 0.0),
+                         _mm256_set_pd(7.0, 6.0, 5.0, 4.0) };
+    __m256d maxIndex[2] = { index[0], index[1] };
+    __m256d maxValue[2] = { _mm256_set1_pd(-1.0), _mm256_set1_pd(-1.0) };
+
+    int i = 0;
+    for (; i+8<=count; i+=8) {
+        for (int k=0; k<2; ++k) {
+            auto px = _mm256_sub_pd(_mm256_loadu_pd(x + i + 4*k), vsx);
+            auto py = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(y + i + 4*k)), vsy);
+            auto cross = _mm256_sub_pd(_mm256_mul_pd(vdx, py), _mm256_mul_pd(vdy, px));
+            cross = _mm256_mul_pd(cross, cross);
+            auto greater = _mm256_cmp_pd(cross, maxValue[k], _CMP_GT_OQ);
+            maxValue[k] = _mm256_blendv_pd(maxValue[k], cross, greater);
+            maxIndex[k] = _mm256_blendv_pd(maxIndex[k], index[k], greater);
+            index[k] = _mm256_add_pd(index[k], step);
+        }
+    }
+
+    alignas(32) double values[8];
+    alignas(32) double indices[8];
+    _mm256_store_pd(values, maxValue[0]);
+    _mm256_store_pd(values + 4, maxValue[1]);
+    _mm256_store_pd(indices, maxIndex[0]);
+    _mm256_store_pd(indices + 4, maxIndex[1]);
+    auto result = reduce(values, indices, 8, maxCross);
+
+    if (i < count) {
+        double tailCross;
+        auto tail = farthestScalar(x + i, y + i, count - i, sx, sy, dx, dy, tailCross);
+        if (tailCross > maxCross) {
+            maxCross = tailCross;
+            result = i + tail;
+        }
+    }
+    return result;
+}
+
+bool hasAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // The OS has to save the YMM registers on context switches.
+    auto osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+Kernel kernel(DistanceKernel::InstructionSet instructionSet)
+{
+#ifdef MPT_KERNEL_X86
+    switch (instructionSet) {
+    case DistanceKernel::InstructionSet::Avx2:
+        return farthestAvx2;
+    case DistanceKernel::InstructionSet::Sse2:
+        return farthestSse2;
+    case DistanceKernel::InstructionSet::Scalar:
+        break;
+    }
+#else
+    Q_UNUSED(instructionSet)
+#endif
+    return farthestScalar<double>;
+}
+
+DistanceKernel::InstructionSet detect()
+{
+    // The vector kernels read the x column as doubles.
+    if (!std::is_same<qreal, double>::value)
+        return DistanceKernel::InstructionSet::Scalar;
+#ifdef MPT_KERNEL_X86
+    if (hasAvx2())
+        return DistanceKernel::InstructionSet::Avx2;
+    return DistanceKernel::InstructionSet::Sse2;
+#else
+    return DistanceKernel::InstructionSet::Scalar;
+#endif
+}
+
+} // namespace
+
+DistanceKernel::DistanceKernel()
+{
+
+}
+
+DistanceKernel::InstructionSet DistanceKernel::supported()
+{
+    static const auto instructionSet = detect();
+    return instructionSet;
+}
+
+int DistanceKernel::farthest(const qreal *x, const float *y, int count,
+                             const QPointF &start, const QPointF &end,
+                             qreal &squaredDistance)
+{
+    return farthest(x, y, count, start, end, squaredDistance, supported());
+}
+
+int DistanceKernel::farthest(const qreal *x, const float *y, int count,
+                             const QPointF &start, const QPointF &end,
+                             qreal &squaredDistance, InstructionSet instructionSet)
+{
+    squaredDistance = 0.0;
+    if (count <= 0)
+        return -1;
+
+    auto dx = end.x() - start.x();
+    auto dy = end.y() - start.y();
+    auto magnitude = dx * dx + dy * dy;
+
+    // Degenerated line; fall back to the distance to start.
+    if (magnitude == 0.0) {
+        int index = 0;
+        for (int i=0; i<count; ++i) {
+            auto px = x[i] - start.x();
+            auto py = qreal(y[i]) - start.y();
+            auto distance = px * px + py * py;
+            if (distance > squaredDistance) {
+                squaredDistance = distance;
+                index = i;
+            }
+        }
+        return index;
+    }
+
+    if (instructionSet > supported())
+        instructionSet = supported();
+    double maxCross;
+    int index;
+    if (std::is_same<qreal, double>::value) {
+        index = kernel(instructionSet)(reinterpret_cast<const double*>(x), y, count,
+                                       start.x(), start.y(), dx, dy, maxCross);
+    } else {
+        // supported() is Scalar then; x must not be read as doubles.
+        index = farthestScalar(x, y, count, start.x(), start.y(), dx, dy, maxCross);
+    }
+    squaredDistance = maxCross / magnitude;
+    return index;
+}
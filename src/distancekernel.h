@@ -0,0 +1,70 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DISTANCEKERNEL_H
+#define DISTANCEKERNEL_H
+
+#include <QPointF>
+
+/**
+ * @brief Vectorized search for the point farthest from a line.
+ *
+ * This is the innermost loop of the Douglas-Peucker simplification. The
+ * kernel compares squared distances only, so neither square roots nor
+ * divisions are needed per point. SSE2 and AVX2 variants are selected at
+ * runtime; all variants return the same index, which is the first one in
+ * case of ties. The points are read from separate x and y columns, so
+ * the vector loops neither shuffle nor mix coordinates.
+ */
+class DistanceKernel final
+{
+private:
+    DistanceKernel();
+
+public:
+    enum class InstructionSet {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    /**
+     * @brief The best instruction set supported by the CPU.
+     */
+    static InstructionSet supported();
+
+    /**
+     * @brief Finds the point of (x, y)[0..count) farthest from the line
+     *        through start and end.
+     *
+     * Returns the index of that point and stores its squared perpendicular
+     * distance in squaredDistance. If start and end are equal the squared
+     * distance to start is used. Returns -1 if count is not positive.
+     */
+    static int farthest(const qreal *x, const float *y, int count,
+                        const QPointF &start, const QPointF &end,
+                        qreal &squaredDistance);
+
+    static int farthest(const qreal *x, const float *y, int count,
+                        const QPointF &start, const QPointF &end,
+                        qreal &squaredDistance, InstructionSet instructionSet);
+};
+
+#endif // DISTANCEKERNEL_H
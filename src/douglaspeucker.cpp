@@ -19,76 +19,223 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "douglaspeucker.h"
+#include "distancekernel.h"
 
-#include <QtMath>
+#include <QQueue>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
 
 DouglasPeucker::DouglasPeucker()
 {
 
 }
 
-void DouglasPeucker::douglasPeucker(const QVector<QPointF> &data, qreal epsilon,
+void DouglasPeucker::douglasPeucker(const ChannelView &data, qreal epsilon,
                                     QVector<QPointF> &result)
 {
     if (data.size()<2) {
-        result = data;
+        result.clear();
+        if (!data.isEmpty())
+            result.append(data.first());
         return;
     }
 
-    qreal dmax = 0.0;
-    int index = 0;
+    QVector<int> indices;
+    parallelDouglasPeucker(data, 0, data.size()-1, epsilon, indices);
+
+    result.clear();
+    result.reserve(indices.size());
+    for (auto index: indices)
+        result.append(data[index]);
+}
+
+void DouglasPeucker::douglasPeucker(const ChannelView &data, int first, int last,
+                                    qreal epsilon, QVector<int> &indices,
+                                    QVector<Range> &stack)
+{
+    indices.clear();
+    stack.clear();
+    if (first > last)
+        return;
+
+    // Squared distances are compared, which saves the square roots.
+    auto epsilon2 = epsilon * epsilon;
+
+    // The left half is always processed before the right half, so each
+    // accepted range ends right after the previously accepted one and the
+    // indices come out sorted.
+    indices.append(first);
+    if (first == last)
+        return;
+    stack.append({ first, last });
 
-    for (int i=1; i<data.size()-1; ++i) {
-        auto pd = perpendicularDistance(data[i], data.first(), data.last());
-        if (pd > dmax) {
-            index = i;
-            dmax = pd;
+    while (!stack.isEmpty()) {
+        auto range = stack.takeLast();
+
+        qreal dmax2;
+        auto index = farthest(data, range, dmax2);
+
+        if (dmax2 > epsilon2) {
+            stack.append({ index, range.last });
+            stack.append({ range.first, index });
+        } else {
+            indices.append(range.last);
         }
     }
+}
 
-    if (dmax > epsilon) {
-        QVector<QPointF> result1;
-        QVector<QPointF> result2;
-        douglasPeucker(data.mid(0, index+1), epsilon,result1);
-        douglasPeucker(data.mid(index), epsilon, result2);
-
-        result = result1.mid(0, result1.length()-1);
-        result.append(result2);
+void DouglasPeucker::parallelDouglasPeucker(const ChannelView &data, int first, int last,
+                                            qreal epsilon, QVector<int> &indices)
+{
+    struct Task {
+        Range range;
+        QVector<int> indices;
+    };
+
+    indices.clear();
+    if (last - first < ParallelThreshold) {
+        QVector<Range> stack;
+        douglasPeucker(data, first, last, epsilon, indices, stack);
         return;
     }
 
-    result.clear();
-    result.push_back(data.first());
-    result.push_back(data.last());
+    // Split breadth-first until the ranges are small enough or there are
+    // plenty of them for the pool; the splits are exactly the ones the
+    // serial variant makes, so is the result.
+    auto epsilon2 = epsilon * epsilon;
+    auto maxTasks = 4 * QThread::idealThreadCount();
+    QQueue<Range> pending;
+    QVector<Task> tasks;
+    pending.enqueue({ first, last });
+    while (!pending.isEmpty()) {
+        auto range = pending.dequeue();
+        if (range.last - range.first < ParallelThreshold ||
+                tasks.size() + pending.size() >= maxTasks) {
+            tasks.append({ range, {} });
+            continue;
+        }
+
+        qreal dmax2;
+        auto index = farthest(data, range, dmax2);
+        if (dmax2 > epsilon2) {
+            pending.enqueue({ range.first, index });
+            pending.enqueue({ index, range.last });
+        } else {
+            tasks.append({ range, {} });
+        }
+    }
+
+    QtConcurrent::blockingMap(tasks, [&data, epsilon](Task &task) {
+        QVector<Range> stack;
+        douglasPeucker(data, task.range.first, task.range.last, epsilon,
+                       task.indices, stack);
+    });
+
+    // Adjacent ranges share their end points.
+    std::sort(tasks.begin(), tasks.end(), [](const Task &a, const Task &b) {
+        return a.range.first < b.range.first;
+    });
+    indices.append(first);
+    for (auto &task: tasks) {
+        for (int i=1; i<task.indices.size(); ++i)
+            indices.append(task.indices[i]);
+    }
+}
+
+void DouglasPeucker::significance(const ChannelView &data, int first, int last,
+                                  QVector<qreal> &significance,
+                                  QVector<Range> &stack)
+{
+    stack.clear();
+    if (first > last)
+        return;
+
+    significance[first] = std::numeric_limits<qreal>::max();
+    significance[last] = std::numeric_limits<qreal>::max();
+    if (last - first < 2)
+        return;
+
+    auto values = significance.data();
+    stack.append({ first, last });
+    while (!stack.isEmpty())
+        splitSignificance(data, stack.takeLast(), values, stack);
 }
 
-qreal DouglasPeucker::perpendicularDistance(const QPointF &point,
-                                            const QPointF &start,
-                                            const QPointF &end)
+void DouglasPeucker::parallelSignificance(const ChannelView &data, int first, int last,
+                                          QVector<qreal> &significance)
 {
-    qreal dx = end.x() - start.x();
-    qreal dy = end.y() - start.y();
-
-    // normalize
-    qreal mag = qSqrt(qPow(dx, 2.0) + qPow(dy, 2.0));
-    if (mag > 0.0) {
-        dx /= mag;
-        dy /= mag;
+    QVector<Range> stack;
+    if (last - first < ParallelThreshold) {
+        DouglasPeucker::significance(data, first, last, significance, stack);
+        return;
     }
 
-    qreal pvx = point.x() - start.x();
-    qreal pvy = point.y() - start.y();
+    significance[first] = std::numeric_limits<qreal>::max();
+    significance[last] = std::numeric_limits<qreal>::max();
+
+    // Same breadth-first split as in parallelDouglasPeucker(). The tasks
+    // write disjoint ranges of significance; shared end points were written
+    // before the tasks start.
+    auto values = significance.data();
+    auto maxTasks = 4 * QThread::idealThreadCount();
+    QQueue<Range> pending;
+    QVector<Range> tasks;
+    pending.enqueue({ first, last });
+    while (!pending.isEmpty()) {
+        auto range = pending.dequeue();
+        if (range.last - range.first < ParallelThreshold ||
+                tasks.size() + pending.size() >= maxTasks) {
+            tasks.append(range);
+            continue;
+        }
 
-    // get dot product (project pv onto normalized direction)
-    qreal pvdot = dx * pvx + dy * pvy;
+        stack.clear();
+        splitSignificance(data, range, values, stack);
+        for (auto &child: stack)
+            pending.enqueue(child);
+    }
 
-    // scale line direction vector
-    qreal dsx = pvdot * dx;
-    qreal dsy = pvdot * dy;
+    QtConcurrent::blockingMap(tasks, [&data, values](Range &range) {
+        QVector<Range> stack{ range };
+        while (!stack.isEmpty())
+            splitSignificance(data, stack.takeLast(), values, stack);
+    });
+}
 
-    // substract this from pv
-    qreal ax = pvx - dsx;
-    qreal ay = pvy - dsy;
+void DouglasPeucker::splitSignificance(const ChannelView &data, const Range &range,
+                                       qreal *significance, QVector<Range> &stack)
+{
+    // Unlike douglasPeucker() every range is split until it is empty. A
+    // point is only reached if all ranges containing it were split, so its
+    // significance is capped by the smaller significance of the range's end
+    // points, which are the split points of its ancestors.
+    auto bound = qMin(significance[range.first], significance[range.last]);
+
+    qreal dmax2;
+    auto index = farthest(data, range, dmax2);
+
+    if (dmax2 > 0.0) {
+        significance[index] = qMin(dmax2, bound);
+        if (index - range.first > 1)
+            stack.append({ range.first, index });
+        if (range.last - index > 1)
+            stack.append({ index, range.last });
+    } else {
+        for (int i=range.first+1; i<range.last; ++i)
+            significance[i] = 0.0;
+    }
+}
 
-    return qSqrt(qPow(ax, 2.0) + qPow(ay, 2.0));
+int DouglasPeucker::farthest(const ChannelView &data, const Range &range,
+                             qreal &squaredDistance)
+{
+    auto offset = DistanceKernel::farthest(data.x() + range.first + 1,
+                                           data.y() + range.first + 1,
+                                           range.last - range.first - 1,
+                                           data[range.first], data[range.last],
+                                           squaredDistance);
+    return range.first + 1 + offset;
 }
@@ -21,6 +21,8 @@
 #ifndef DOUGLASPEUCKER_H
 #define DOUGLASPEUCKER_H
 
+#include "channelview.h"
+
 #include <QVector>
 #include <QPointF>
 
@@ -36,13 +38,75 @@ private:
     DouglasPeucker();
 
 public:
-    static void douglasPeucker(const QVector<QPointF> &data, qreal epsilon,
+    /**
+     * @brief Closed index range [first, last] into the simplified data.
+     */
+    struct Range {
+        int first;
+        int last;
+    };
+
+    static void douglasPeucker(const ChannelView &data, qreal epsilon,
                                QVector<QPointF> &result);
 
+    /**
+     * @brief Simplifies data[first..last] in place of the recursive variant.
+     *
+     * The indices of all kept points are written to indices in ascending
+     * order. The points are never copied and no recursion takes place;
+     * pending ranges are kept on the explicit stack. Both buffers are
+     * cleared but keep their capacity, so callers reusing them across calls
+     * do not allocate once they are warmed up.
+     */
+    static void douglasPeucker(const ChannelView &data, int first, int last,
+                               qreal epsilon, QVector<int> &indices,
+                               QVector<Range> &stack);
+
+    /**
+     * @brief Like the index variant of douglasPeucker(), but large ranges
+     *        are split into subtrees that are simplified concurrently.
+     *
+     * The result is identical to the serial variant.
+     */
+    static void parallelDouglasPeucker(const ChannelView &data, int first, int last,
+                                       qreal epsilon, QVector<int> &indices);
+
+    /**
+     * @brief Computes the significance of every point in data[first..last].
+     *
+     * The significance of a point is the square of the largest epsilon for
+     * which douglasPeucker() still keeps it, i.e. a point is kept exactly if
+     * its significance is greater than epsilon². Both end points are always
+     * kept and get the maximum value of qreal. Once computed, simplifying for
+     * any epsilon is a single linear pass over the values.
+     *
+     * significance must have at least last+1 elements; only the values in
+     * [first, last] are written.
+     */
+    static void significance(const ChannelView &data, int first, int last,
+                             QVector<qreal> &significance,
+                             QVector<Range> &stack);
+
+    /**
+     * @brief Like significance(), but large ranges are split into subtrees
+     *        that are computed concurrently.
+     */
+    static void parallelSignificance(const ChannelView &data, int first, int last,
+                                     QVector<qreal> &significance);
+
 private:
-    static qreal perpendicularDistance(const QPointF &point,
-                                       const QPointF &start,
-                                       const QPointF &end);
+    /**
+     * @brief Ranges with fewer points are not worth a task of their own.
+     */
+    static const int ParallelThreshold = 1 << 15;
+
+    static void splitSignificance(const ChannelView &data, const Range &range,
+                                  qreal *significance, QVector<Range> &stack);
+
+    static int farthest(const ChannelView &data, const Range &range,
+                        qreal &squaredDistance);
 };
 
+Q_DECLARE_TYPEINFO(DouglasPeucker::Range, Q_PRIMITIVE_TYPE);
+
 #endif // DOUGLASPEUCKER_H
@@ -0,0 +1,105 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "latencyhistogram.h"
+
+#include <QFile>
+
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const int BucketCount = static_cast<int>(LatencyHistogram::Range / LatencyHistogram::BucketWidth);
+
+} // namespace
+
+constexpr qreal LatencyHistogram::BucketWidth;
+
+LatencyHistogram::LatencyHistogram()
+    : _buckets(BucketCount + 1)
+{
+}
+
+qint64 LatencyHistogram::now()
+{
+    // QElapsedTimer has no shared epoch across timers; steady_clock does.
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyHistogram::clear()
+{
+    _buckets.fill(0);
+    _count = 0;
+    _sum = 0.0;
+    _max = 0;
+}
+
+void LatencyHistogram::add(qint64 nsecs, qint64 count)
+{
+    if (count <= 0)
+        return;
+    nsecs = qMax(nsecs, qint64(0));
+    auto bucket = static_cast<qint64>(nsecs / (BucketWidth * 1e6));
+    _buckets[static_cast<int>(qMin(bucket, qint64(BucketCount)))] += count;
+    _count += count;
+    _sum += static_cast<qreal>(nsecs) * count;
+    _max = qMax(_max, nsecs);
+}
+
+qreal LatencyHistogram::mean() const
+{
+    return _count > 0 ? _sum / _count / 1e6 : 0.0;
+}
+
+qreal LatencyHistogram::percentile(qreal p) const
+{
+    if (_count == 0)
+        return 0.0;
+    auto rank = qMax(qint64(1), static_cast<qint64>(std::ceil(p * _count)));
+    qint64 seen = 0;
+    for (int i=0; i<BucketCount; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank)
+            return qMin((i + 1) * BucketWidth, max());
+    }
+    return max();
+}
+
+bool LatencyHistogram::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QByteArray data("fromMs,toMs,samples\n");
+    for (int i=0; i<=BucketCount; ++i) {
+        if (_buckets[i] == 0)
+            continue;
+        data.append(QByteArray::number(i * BucketWidth)).append(',');
+        if (i < BucketCount)
+            data.append(QByteArray::number((i + 1) * BucketWidth));
+        else
+            data.append("inf");
+        data.append(',').append(QByteArray::number(_buckets[i])).append('\n');
+    }
+    return file.write(data) == data.size() && file.flush();
+}
@@ -0,0 +1,99 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Distribution of the delay between the arrival of samples and
+ *        their appearance on the chart.
+ *
+ * The delays are counted per sample in buckets of BucketWidth ms up to
+ * Range ms; longer ones share an overflow bucket. Percentiles are given by
+ * the upper edge of their bucket, so they overestimate by less than a
+ * bucket.
+ */
+class LatencyHistogram final
+{
+public:
+    /**
+     * @brief Samples received at the same time.
+     */
+    struct Arrival {
+        qint64 nsecs = 0;
+        int samples = 0;
+    };
+
+    static constexpr qreal BucketWidth = 0.5;
+    static const int Range = 1000;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Monotonic time in ns, the same on all threads.
+     */
+    static qint64 now();
+
+    void clear();
+
+    /**
+     * @brief Adds count samples that took nsecs from arrival to display.
+     */
+    void add(qint64 nsecs, qint64 count = 1);
+
+    qint64 count() const {
+        return _count;
+    }
+
+    /**
+     * @brief Mean latency in ms.
+     */
+    qreal mean() const;
+
+    /**
+     * @brief Longest latency in ms.
+     */
+    qreal max() const {
+        return _max / 1e6;
+    }
+
+    /**
+     * @brief Latency in ms that a fraction p of the samples did not exceed.
+     */
+    qreal percentile(qreal p) const;
+
+    /**
+     * @brief Writes the non-empty buckets as CSV.
+     */
+    bool save(const QString &fileName) const;
+
+private:
+    QVector<qint64> _buckets;
+    qint64 _count = 0;
+    qreal _sum = 0.0;
+    qint64 _max = 0;
+};
+
+Q_DECLARE_TYPEINFO(LatencyHistogram::Arrival, Q_PRIMITIVE_TYPE);
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,144 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "lodpyramid.h"
+#include "minmaxdecimator.h"
+
+LodPyramid::LodPyramid()
+{
+
+}
+
+void LodPyramid::clear()
+{
+    _size = 0;
+    _depth = 0;
+    for (auto &level: _levels)
+        level.resize(0);
+}
+
+void LodPyramid::reserve(int size)
+{
+    // The same levels update() creates for size samples.
+    auto count = (size + (1 << MinLevel) - 1) >> MinLevel;
+    for (int level=0; ; ++level) {
+        if (_levels.size() == level)
+            _levels.resize(level + 1);
+        _levels[level].reserve(count);
+        if (count <= 1)
+            break;
+        count = (count + 1) / 2;
+    }
+}
+
+void LodPyramid::update(const ChannelView &data)
+{
+    if (data.size() < _size)
+        clear();
+    if (data.size() == _size)
+        return;
+
+    // Only buckets that were incomplete or did not exist yet are computed.
+    auto size = data.size();
+    auto bucketSize = 1 << MinLevel;
+    int count = (size + bucketSize - 1) / bucketSize;
+    if (_levels.isEmpty())
+        _levels.resize(1);
+    _depth = qMax(_depth, 1);
+    auto y = data.y();
+    auto &finest = _levels.first();
+    finest.resize(count);
+    for (int b=_size/bucketSize; b<count; ++b) {
+        auto first = b * bucketSize;
+        auto last = qMin(first + bucketSize, size);
+        Bucket bucket{ first, first };
+        for (int i=first+1; i<last; ++i) {
+            if (y[i] < y[bucket.min])
+                bucket.min = i;
+            if (y[i] > y[bucket.max])
+                bucket.max = i;
+        }
+        finest[b] = bucket;
+    }
+
+    for (int level=1; count > 1; ++level) {
+        if (_levels.size() == level)
+            _levels.resize(level + 1);
+        _depth = qMax(_depth, level + 1);
+        auto &source = _levels[level-1];
+        auto &target = _levels[level];
+        count = (source.size() + 1) / 2;
+        target.resize(count);
+        for (int b=_size>>(level+MinLevel); b<count; ++b) {
+            target[b] = 2*b+1 < source.size()
+                    ? merge(y, source[2*b], source[2*b+1])
+                    : source[2*b];
+        }
+    }
+
+    _size = size;
+}
+
+void LodPyramid::query(const ChannelView &data, qreal minX, qreal maxX, int width,
+                       QVector<QPointF> &result) const
+{
+    result.clear();
+    if (data.isEmpty() || width <= 0 || maxX <= minX)
+        return;
+
+    int first = data.lowerBound(minX);
+    int last = data.upperBound(maxX);
+    first = qMax(first - 1, 0);
+    last = qMin(last, data.size() - 1);
+    auto count = last - first + 1;
+
+    int level = -1;
+    while (level+1 < _depth && (count >> (level+1+MinLevel)) >= width)
+        ++level;
+
+    // Fewer than one bucket per pixel on every level; the raw samples are
+    // cheap enough then.
+    if (level < 0) {
+        MinMaxDecimator::decimate(data, minX, maxX, width, result);
+        return;
+    }
+
+    auto &buckets = _levels[level];
+    auto shift = level + MinLevel;
+    auto lastBucket = qMin(last >> shift, buckets.size() - 1);
+    for (int b=first>>shift; b<=lastBucket; ++b) {
+        auto &bucket = buckets[b];
+        if (bucket.min == bucket.max) {
+            result.append(data[bucket.min]);
+        } else if (bucket.min < bucket.max) {
+            result.append(data[bucket.min]);
+            result.append(data[bucket.max]);
+        } else {
+            result.append(data[bucket.max]);
+            result.append(data[bucket.min]);
+        }
+    }
+}
+
+LodPyramid::Bucket LodPyramid::merge(const float *y, const Bucket &a, const Bucket &b)
+{
+    return { y[b.min] < y[a.min] ? b.min : a.min,
+             y[b.max] > y[a.max] ? b.max : a.max };
+}
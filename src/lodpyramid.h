@@ -0,0 +1,95 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef LODPYRAMID_H
+#define LODPYRAMID_H
+
+#include "channelview.h"
+
+#include <QVector>
+#include <QPointF>
+
+/**
+ * @brief Multi-resolution min/max pyramid over a growing sample buffer.
+ *
+ * Level i aggregates 2^(i+MinLevel) consecutive samples into their minimum
+ * and maximum. Appending samples only touches the last bucket of each
+ * level, and a query for any visible x range is answered from the coarsest
+ * level that still has at least one bucket per pixel. Zooming and
+ * scrolling thus cost O(visible pixels) regardless of the session length.
+ */
+class LodPyramid final
+{
+public:
+    /**
+     * @brief Indices of the minimum and maximum sample of a bucket.
+     */
+    struct Bucket {
+        int min;
+        int max;
+    };
+
+    LodPyramid();
+
+    void clear();
+
+    int levels() const {
+        return _depth;
+    }
+
+    /**
+     * @brief Allocates the levels for size samples, so that updates up to
+     *        that size do not allocate.
+     *
+     * The levels keep their capacity across clear().
+     */
+    void reserve(int size);
+
+    void update(const ChannelView &data);
+
+    /**
+     * @brief Collects the points to draw data in [minX, maxX] on width pixels.
+     *
+     * data must be the buffer the pyramid was last updated with and sorted
+     * by x. At most about four points per pixel are returned.
+     */
+    void query(const ChannelView &data, qreal minX, qreal maxX, int width,
+               QVector<QPointF> &result) const;
+
+private:
+    /**
+     * @brief log2 of the bucket size of the finest level.
+     *
+     * Pairs of samples hardly reduce anything, so the finest level starts
+     * at four samples per bucket; all levels together then need about four
+     * bytes per sample.
+     */
+    static const int MinLevel = 2;
+
+    static Bucket merge(const float *y, const Bucket &a, const Bucket &b);
+
+    int _size = 0;
+    int _depth = 0;
+    QVector<QVector<Bucket>> _levels;
+};
+
+Q_DECLARE_TYPEINFO(LodPyramid::Bucket, Q_PRIMITIVE_TYPE);
+
+#endif // LODPYRAMID_H
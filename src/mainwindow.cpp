@@ -20,17 +20,22 @@
  */
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "csvparser.h"
+#include "sessionfile.h"
 
 #include <QActionGroup>
 #include <QAudioRecorder>
 #include <QDateTime>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QLabel>
 #include <QMessageBox>
-#include <QSerialPort>
+#include <QProgressBar>
+#include <QSaveFile>
 #include <QSpinBox>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QToolButton>
 #include <QValueAxis>
 #include <QXYSeries>
 
@@ -49,34 +54,41 @@ MainWindow::MainWindow(QWidget *parent)
     if (!dir.exists())
         dir.mkpath(dir.absolutePath());
 
-    _ui->chartView->chart()->addSeries(_serialReader.airSeries1());
-    _ui->chartView->chart()->addSeries(_serialReader.airSeries2());
-    _ui->chartView->chart()->addSeries(_serialReader.airSeries3());
-    _ui->chartView->chart()->addSeries(_serialReader.pulseSeries());
-
     setupAxisX();
     setupAxisY();
     setupDpEpsilon();
-
+    setupLoadProgress();
+    setupStats();
+    setupChannelMenu();
+    _dataLogModel.setMaximumSize(_initSize);
+    _ui->dataLog->setModel(&_dataLogModel);
+
+    _serialReader.setMemoryBudget(_memoryBudget);
+    _serialReader.setFrameRate(_frameRate);
     _serialReader.setAxisX(_ui->chartView->axisX());
-    _serialReader.airSeries1()->attachAxis(_ui->chartView->axisX());
-    _serialReader.airSeries1()->attachAxis(_ui->chartView->axisY());
-    _serialReader.airSeries2()->attachAxis(_ui->chartView->axisX());
-    _serialReader.airSeries2()->attachAxis(_ui->chartView->axisY());
-    _serialReader.airSeries3()->attachAxis(_ui->chartView->axisX());
-    _serialReader.airSeries3()->attachAxis(_ui->chartView->axisY());
-    _serialReader.pulseSeries()->attachAxis(_ui->chartView->axisX());
-    _serialReader.pulseSeries()->attachAxis(_ui->chartView->axisY());
+    setupChannels();
 
     connect(&_timer, &QTimer::timeout, &_serialReader, &SerialReader::read);
+    connect(&_serialReader, &SerialReader::schemaChanged,
+            this, &MainWindow::setupChannels);
     connect(&_serialReader, &SerialReader::arduinoStarted,
                 this, &MainWindow::recordAudio);
     connect(&_serialReader, &SerialReader::newData,
             this, &MainWindow::showNewData);
     connect(_ui->chartView, &ChartView::axisValuesChanged,
             this, &MainWindow::setAxisValues);
+    connect(_ui->chartView, &ChartView::painted,
+            &_serialReader, &SerialReader::chartPainted);
+    connect(_ui->chartView->chart(), &QChart::plotAreaChanged,
+            this, &MainWindow::plotAreaChanged);
     connect(_audioRecorder, QOverload<QMediaRecorder::Error>::of(&QMediaRecorder::error),
             this, &MainWindow::handleAudioInError);
+    connect(&_recordingLoader, &RecordingLoader::samplesLoaded,
+            &_serialReader, &SerialReader::loadSamples);
+    connect(&_recordingLoader, &RecordingLoader::progress,
+            this, &MainWindow::showLoadProgress);
+    connect(&_recordingLoader, &RecordingLoader::finished,
+            this, &MainWindow::csvLoaded);
 }
 
 MainWindow::~MainWindow()
@@ -87,23 +99,32 @@ MainWindow::~MainWindow()
 void MainWindow::on_actionOpen_CSV_triggered()
 {
     auto fileName = QFileDialog::getOpenFileName(this,
-                                                 tr("Open CSV"),
+                                                 tr("Open Recording"),
                                                  currentFileLocation(),
-                                                 tr("CSV (*.csv)"));
+                                                 tr("Recordings (*.csv *.mpts);;CSV (*.csv);;Sessions (*.mpts)"));
     if (fileName.isEmpty())
         return;
-    QFile file(fileName);
-    if (file.open(QFile::ReadOnly)) {
-        _rawData = file.readAll();
-        _ui->dataLog->setPlainText(_rawData);
-        _rawLines = _rawData.split('\n');
-        if (_rawLines.first().startsWith("ms"))
-            _rawLines.removeFirst();
-        _serialReader.load(_rawLines);
-        file.close();
-    } else {
-        appendLog(QString("Error: Could not open CSV file %1.").arg(fileName));
+
+    // The data log may still refer to the previous mapping.
+    _recordingLoader.cancel();
+    _journalFileName.clear();
+    _dataLogModel.clear();
+    _serialReader.clear();
+    if (!_recordingLoader.open(fileName)) {
+        appendLog("Error: " + _recordingLoader.errorString());
+        return;
+    }
+    if (_recordingLoader.isSession()) {
+        // Only the index is read; the chart pages in what it shows.
+        _serialReader.setSession(&_recordingLoader.session());
+        return;
     }
+    _serialReader.setSchema(_recordingLoader.schema());
+    _dataLogModel.setRawData(_recordingLoader.data(), 0);
+
+    _loadProgress->setValue(0);
+    _loadProgress->show();
+    _cancelLoadButton->show();
 }
 
 void MainWindow::on_actionExportCSV_triggered()
@@ -116,17 +137,140 @@ void MainWindow::on_actionExportCSV_triggered()
         return;
     if (!fileName.endsWith(".csv", Qt::CaseInsensitive))
         fileName.append(".csv");
-    QFile file(fileName);
+    if (isSessionFile(fileName)) {
+        appendLog(QString("Error: %1 is in use by the current session.").arg(fileName));
+        return;
+    }
+
+    if (!_recordingLoader.isSession()) {
+        // The journal and an opened CSV file already are the export.
+        auto source = csvFileName();
+        if (source.isEmpty()) {
+            appendLog("Error: There is no data to export.");
+            return;
+        }
+        if (!copyFile(source, fileName)) {
+            appendLog(QString("Error: Could not copy %1 to %2.").arg(source).arg(fileName));
+            return;
+        }
+        if (source != _journalFileName)
+            return;
+        if (_journal.hasFailed())
+            appendLog(QString("Warning: The export is incomplete. %1")
+                      .arg(_journal.errorString()));
+        else if (_journal.droppedChunks() > 0)
+            appendLog(QString("Warning: %1 chunks are missing from the export.")
+                      .arg(_journal.droppedChunks()));
+        return;
+    }
+
+    // An existing file is only replaced once the export is complete.
+    QSaveFile file(fileName);
     if (file.open(QFile::WriteOnly)) {
+        // A session has no raw text; its samples are written instead.
         QTextStream stream(&file);
-        stream << "ms,sync,air1,air2,air3,pulse";
-        stream << _rawData;
-        file.close();
+        auto &session = _recordingLoader.session();
+        auto channels = session.schema().count();
+        stream << session.schema().header();
+        QVector<Sample> samples;
+        for (int i=0; i<session.chunks().size(); ++i) {
+            samples.clear();
+            session.read(i, samples);
+            for (auto &sample: samples) {
+                stream << '\n' << QByteArray::number(sample.ms, 'g', 15)
+                       << ',' << sample.sync;
+                for (int channel=0; channel<channels; ++channel)
+                    stream << ',' << sample.values[channel];
+            }
+        }
+        stream.flush();
+        if (stream.status() != QTextStream::Ok || !file.commit())
+            appendLog(QString("Error: Could not write export file %1.").arg(fileName));
     } else {
         appendLog(QString("Error: Could not open export file %1.").arg(fileName));
     }
 }
 
+void MainWindow::on_actionSaveSession_triggered()
+{
+    auto fileName = QFileDialog::getSaveFileName(this,
+                                                 tr("Save Session"),
+                                                 currentFileLocation(),
+                                                 tr("Sessions (*.mpts)"));
+    if (fileName.isEmpty())
+        return;
+    if (!fileName.endsWith(".mpts", Qt::CaseInsensitive))
+        fileName.append(".mpts");
+    if (isSessionFile(fileName)) {
+        appendLog(QString("Error: %1 is in use by the current session.").arg(fileName));
+        return;
+    }
+
+    if (_recordingLoader.isSession()) {
+        if (!copyFile(_recordingLoader.fileName(), fileName))
+            appendLog(QString("Error: Could not copy session to %1.").arg(fileName));
+        return;
+    }
+
+    QFile source(csvFileName());
+    if (!source.open(QFile::ReadOnly)) {
+        appendLog("Error: There is no data to save.");
+        return;
+    }
+    auto size = source.size();
+    auto begin = reinterpret_cast<const char*>(size > 0 ? source.map(0, size) : nullptr);
+    if (size > 0 && !begin) {
+        appendLog("Error: Could not map " + source.fileName());
+        return;
+    }
+
+    // An existing file is only replaced once the session is complete.
+    QSaveFile file(fileName);
+    if (!file.open(QFile::WriteOnly)) {
+        appendLog(QString("Error: Could not write %1: %2").arg(fileName).arg(file.errorString()));
+        return;
+    }
+
+    // The chart shows the journal or the opened file, so their schemas
+    // are the same.
+    SessionWriter writer;
+    auto &schema = _serialReader.schema();
+    if (!writer.open(&file, schema)) {
+        appendLog("Error: " + writer.errorString());
+        return;
+    }
+    auto end = begin + size;
+    auto ok = true;
+    Sample sample;
+    auto write = [&](const char *lineBegin, const char *lineEnd) {
+        if (ok && CsvParser::parse(lineBegin, lineEnd, schema.count(), sample))
+            ok = writer.append(sample);
+    };
+    auto rest = CsvParser::forEachLine(begin, end, write);
+    write(rest, end);
+    if (!writer.close() || !ok) {
+        appendLog("Error: " + writer.errorString());
+        return;
+    }
+    if (!file.commit())
+        appendLog(QString("Error: Could not replace %1: %2").arg(fileName).arg(file.errorString()));
+}
+
+void MainWindow::on_actionSaveStats_triggered()
+{
+    auto fileName = QFileDialog::getSaveFileName(this,
+                                                 tr("Save Pipeline Statistics"),
+                                                 currentFileLocation(),
+                                                 tr("CSV (*.csv)"));
+    if (fileName.isEmpty())
+        return;
+    if (!fileName.endsWith(".csv", Qt::CaseInsensitive))
+        fileName.append(".csv");
+
+    if (!_serialReader.stats().save(fileName))
+        appendLog(QString("Error: Could not write statistics to %1.").arg(fileName));
+}
+
 void MainWindow::on_actionQuit_triggered()
 {
     close();
@@ -160,24 +304,19 @@ void MainWindow::deviceSelected(QAction *action)
 
 void MainWindow::on_actionConnect_triggered()
 {
-    if (_serialReader.serialPort()->isOpen())
+    if (_serialReader.isOpen())
         return;
 
+    if (_recordingLoader.isLoading())
+        cancelLoad();
     _serialReader.clear();
-    _rawData.clear();
-    _rawLines.clear();
-    _rawData.reserve(_initSize);
-    _ui->dataLog->clear();
+    _dataLogModel.clear();
+    _dataLogModel.reserve(_initSize);
+    _recordingLoader.close();
+    _journalFileName.clear();
     on_actionReset_Zoom_triggered();
 
     auto baud = _baudGroup->checkedAction()->text().toInt();
-    if (!_serialReader.serialPort()->setBaudRate(baud, QSerialPort::AllDirections)) {
-        appendLog(QString("Error code: %1\n Message: %2")
-                  .arg(_serialReader.serialPort()->error())
-                  .arg(_serialReader.serialPort()->errorString()));
-        return;
-    }
-
     auto action = _portGroup->checkedAction();
     if (!action) return;
     auto portInfo = _serialPortInfos.value(action->text());
@@ -186,34 +325,55 @@ void MainWindow::on_actionConnect_triggered()
     if (portInfo.isNull()) {
         appendLog("ERROR: no valid serial port found!");
         return;
-    } else {
-        _serialReader.serialPort()->setPort(portInfo);
     }
 
     appendLog(QString("Start reading data. Baud: %1 Port: %2")
-              .arg(_serialReader.serialPort()->baudRate())
-              .arg(_serialReader.serialPort()->portName()));
-    if (!_serialReader.serialPort()->open(QIODevice::ReadOnly)) {
-        appendLog(QString("Failed to open port %1 error: %2")
-                  .arg(_serialReader.serialPort()->portName())
-                  .arg(_serialReader.serialPort()->errorString()));
+              .arg(baud)
+              .arg(portInfo.portName()));
+    if (!_serialReader.open(portInfo, baud)) {
+        appendLog(_serialReader.errorString());
         return;
     }
 
-    // Required on Windows; otherwise the Arduion restart does not happen
-    _serialReader.serialPort()->setRequestToSend(true);
-    _serialReader.serialPort()->setDataTerminalReady(true);
+    // Everything received goes to the journal right away; the data log
+    // only keeps the latest part in memory. The received data starts with
+    // the header of the device's channels.
+    createSessionDirectory();
+    if (_journal.open(sessionFilePath(_currentSubDir + ".csv"))) {
+        _journalFileName = _journal.fileName();
+        appendLog("Recording to " + _journalFileName);
+    }
+    else
+        appendLog("Error: " + _journal.errorString());
+
+    // Samples beyond the memory budget are paged out to the history.
+    if (!_serialReader.setHistoryFile(sessionFilePath(_currentSubDir + ".mpts")))
+        appendLog("Error: " + _serialReader.historyErrorString());
 
+    // The port is read on its own thread; the timer only collects whatever
+    // arrived in the meantime. The chart is redrawn at its own frame rate.
     _timer.start(_timer_msec);
 }
 
 void MainWindow::on_actionDisconnect_triggered()
 {
-    if (!_serialReader.serialPort()->isOpen())
+    if (!_serialReader.isOpen())
         return;
-    _serialReader.serialPort()->close();
+    _serialReader.close();
     _timer.stop();
+    _serialReader.read();
+    _journal.close();
     appendLog("Data recoding stopped.");
+    if (_journal.hasFailed())
+        appendLog(QString("Error: %1; %2 is incomplete.")
+                  .arg(_journal.errorString()).arg(_journalFileName));
+    if (_journal.droppedChunks() > 0)
+        appendLog(QString("Warning: The journal could not keep up and lost %1 chunks; "
+                          "%2 has gaps.").arg(_journal.droppedChunks()).arg(_journalFileName));
+    if (_serialReader.droppedChunks() > 0)
+        appendLog(QString("Warning: %1 chunks of raw data were dropped; the data log "
+                          "and the journal have gaps.").arg(_serialReader.droppedChunks()));
+    saveLatency();
 
     if (_audioRecorder->state() ^ QMediaRecorder::RecordingState ||
             _audioRecorder->state() ^ QMediaRecorder::PausedState) {
@@ -240,9 +400,58 @@ void MainWindow::on_actionReset_Zoom_triggered()
     setAxisValues();
 }
 
-void MainWindow::on_actionPulse_triggered()
+void MainWindow::channelToggled(QAction *action)
 {
-    _serialReader.showPulse(_ui->actionPulse->isChecked());
+    // Hidden channels stay hidden by name when the schema changes.
+    if (action->isChecked())
+        _hiddenChannels.remove(action->text());
+    else
+        _hiddenChannels.insert(action->text());
+    _serialReader.setChannelVisible(action->data().toInt(), action->isChecked());
+
+    if (!_serialReader.isOpen())
+        _serialReader.reload();
+}
+
+void MainWindow::on_actionMinMax_triggered()
+{
+    _serialReader.setDecimation(_ui->actionMinMax->isChecked()
+                                ? SerialReader::Decimation::MinMax
+                                : SerialReader::Decimation::DouglasPeucker);
+
+    if (!_serialReader.isOpen())
+        _serialReader.reload();
+}
+
+void MainWindow::on_actionRasterPlot_triggered()
+{
+    // The series are only drawn empty for the legend then.
+    _serialReader.setPlotItem(_ui->actionRasterPlot->isChecked()
+                              ? _ui->chartView->rasterItem() : nullptr);
+}
+
+void MainWindow::on_actionFollow_triggered()
+{
+    // The view scrolls at its current width; the raster plot then only
+    // draws the newly exposed strip.
+    auto following = _ui->actionFollow->isChecked();
+    _serialReader.setFollowing(following);
+    _ui->chartView->setFollowing(following);
+}
+
+void MainWindow::on_actionPipelineStats_triggered()
+{
+    // Measuring stops with the display, so its cost is only paid while
+    // someone looks at it.
+    auto enabled = _ui->actionPipelineStats->isChecked();
+    _serialReader.stats().setEnabled(enabled);
+    _statsLabel->setVisible(enabled);
+    if (enabled) {
+        showStats();
+        _statsTimer.start(_statsTimer_msec);
+    } else {
+        _statsTimer.stop();
+    }
 }
 
 void MainWindow::on_actionAboutQt_triggered()
@@ -250,11 +459,56 @@ void MainWindow::on_actionAboutQt_triggered()
     QMessageBox::aboutQt(this, tr("About Qt"));
 }
 
+void MainWindow::showLoadProgress(qint64 bytes, qint64 total)
+{
+    _loadProgress->setValue(total > 0 ? static_cast<int>(100 * bytes / total) : 100);
+    _dataLogModel.setAvailable(static_cast<int>(bytes));
+}
+
+void MainWindow::csvLoaded(bool canceled)
+{
+    _loadProgress->hide();
+    _cancelLoadButton->hide();
+    if (canceled)
+        return;
+    _dataLogModel.setAvailable(_dataLogModel.rawData().size());
+    _serialReader.finishLoad();
+}
+
+void MainWindow::cancelLoad()
+{
+    _recordingLoader.cancel();
+    _loadProgress->hide();
+    _cancelLoadButton->hide();
+    appendLog("Loading the CSV file was canceled.");
+}
+
 void MainWindow::showNewData(const QByteArray &data)
 {
-    _rawData.append('\n');
-    _rawData.append(data);
-    _ui->dataLog->appendPlainText(data);
+    _journal.append(data);
+    _dataLogModel.append(data);
+}
+
+void MainWindow::setupChannels()
+{
+    // Series kept from the previous schema are still in the chart.
+    _channelMenu->clear();
+    for (int i=0; i<_serialReader.channelCount(); ++i) {
+        auto series = _serialReader.series(i);
+        if (!series->chart()) {
+            _ui->chartView->chart()->addSeries(series);
+            series->attachAxis(_ui->chartView->axisX());
+            series->attachAxis(_ui->chartView->axisY());
+        }
+
+        auto name = _serialReader.schema().name(i);
+        auto visible = !_hiddenChannels.contains(name);
+        _serialReader.setChannelVisible(i, visible);
+        auto action = _channelMenu->addAction(name);
+        action->setCheckable(true);
+        action->setChecked(visible);
+        action->setData(i);
+    }
 }
 
 void MainWindow::minXChanged(int value)
@@ -307,10 +561,15 @@ void MainWindow::dpEpsilonChanged(double value)
 {
     _serialReader.setDpEpsilon(value);
 
-    if (!_serialReader.serialPort()->isOpen())
+    if (!_serialReader.isOpen())
         _serialReader.reload();
 }
 
+void MainWindow::plotAreaChanged(const QRectF &plotArea)
+{
+    _serialReader.setPlotWidth(qRound(plotArea.width()));
+}
+
 void MainWindow::setupAxisX()
 {
     _minXSpinBox = new QSpinBox(_ui->toolBar);
@@ -338,6 +597,42 @@ void MainWindow::setupAxisX()
     _maxXSpinBox->setEnabled(false);
 }
 
+void MainWindow::setupLoadProgress()
+{
+    _loadProgress = new QProgressBar(_ui->statusBar);
+    _loadProgress->setRange(0, 100);
+    _loadProgress->setMaximumWidth(200);
+    _cancelLoadButton = new QToolButton(_ui->statusBar);
+    _cancelLoadButton->setText("Cancel");
+    _ui->statusBar->addPermanentWidget(_loadProgress);
+    _ui->statusBar->addPermanentWidget(_cancelLoadButton);
+
+    connect(_cancelLoadButton, &QToolButton::clicked, this, &MainWindow::cancelLoad);
+
+    _loadProgress->hide();
+    _cancelLoadButton->hide();
+}
+
+void MainWindow::setupStats()
+{
+    _statsLabel = new QLabel(_ui->statusBar);
+    _statsLabel->setToolTip("Median/99th percentile per tick and points in" +
+                            QString(QChar(0x2192)) + "out of the last " +
+                            QString::number(PipelineStats::Window) + " ticks per stage");
+    _ui->statusBar->addWidget(_statsLabel);
+    _statsLabel->hide();
+
+    _ui->chartView->setStats(&_serialReader.stats());
+    connect(&_statsTimer, &QTimer::timeout, this, &MainWindow::showStats);
+}
+
+void MainWindow::setupChannelMenu()
+{
+    _channelMenu = new QMenu("Channels", this);
+    connect(_channelMenu, &QMenu::triggered, this, &MainWindow::channelToggled);
+    _ui->menuView->insertMenu(_ui->actionMinMax, _channelMenu);
+}
+
 void MainWindow::setupAxisY()
 {
     _minYSpinBox = new QSpinBox(_ui->toolBar);
@@ -423,6 +718,21 @@ void MainWindow::setActionsForPortInfos()
         _portGroup->actions().first()->setChecked(true);
 }
 
+void MainWindow::saveLatency()
+{
+    // From the arrival of the samples to the paint that showed them.
+    auto &latency = _serialReader.latency();
+    if (latency.count() == 0)
+        return;
+    appendLog(QString("Latency: median %1 ms, 99th percentile %2 ms, maximum %3 ms.")
+              .arg(latency.percentile(0.5))
+              .arg(latency.percentile(0.99))
+              .arg(latency.max(), 0, 'f', 1));
+    auto fileName = sessionFilePath(_currentSubDir + "-latency.csv");
+    if (!latency.save(fileName))
+        appendLog(QString("Error: Could not write latency histogram to %1.").arg(fileName));
+}
+
 void MainWindow::appendLog(const QString &log) {
     _ui->statusLog->appendPlainText(log);
 }
@@ -457,6 +767,21 @@ void MainWindow::setAxisValues()
     _maxYSpinBox->setValue(static_cast<int>(_ui->chartView->axisY()->max()));
 }
 
+void MainWindow::showStats()
+{
+    // Samples or raw chunks lost to a full queue mean the GUI fell behind.
+    auto text = _serialReader.stats().toString();
+    auto dropped = _serialReader.droppedSamples();
+    if (dropped > 0)
+        text += QString("  dropped %1").arg(dropped);
+    auto droppedChunks = _serialReader.droppedChunks();
+    if (droppedChunks > 0)
+        text += QString("  dropped %1 raw chunks").arg(droppedChunks);
+    if (_journal.droppedChunks() > 0)
+        text += QString("  journal dropped %1 chunks").arg(_journal.droppedChunks());
+    _statsLabel->setText(text);
+}
+
 void MainWindow::recordAudio()
 {
     if (!_ui->actionRecordAudio->isChecked())
@@ -464,8 +789,6 @@ void MainWindow::recordAudio()
     auto action = _audioInGroup->checkedAction();
     if (!action)
         return;
-    createAudioDirectory();
-
     QAudioEncoderSettings audioSettings;
     audioSettings.setCodec("audio/wav");
     audioSettings.setChannelCount(2);
@@ -473,7 +796,7 @@ void MainWindow::recordAudio()
     _audioRecorder->setEncodingSettings(audioSettings);
     _audioRecorder->setAudioInput(action->text());
 
-    auto url = QUrl::fromLocalFile(audioTargetFilePath(_currentSubDir+".wav"));
+    auto url = QUrl::fromLocalFile(sessionFilePath(_currentSubDir+".wav"));
     if (!_audioRecorder->setOutputLocation(url)) {
         appendLog(_audioRecorder->errorString());
     }
@@ -497,12 +820,52 @@ QString MainWindow::currentFileLocation() const
     return documentsLocation() + "/" + _currentSubDir;
 }
 
-QString MainWindow::audioTargetFilePath(const QString &fileName)
+QString MainWindow::csvFileName() const
+{
+    return _journalFileName.isEmpty() ? _recordingLoader.fileName() : _journalFileName;
+}
+
+bool MainWindow::isSessionFile(const QString &fileName) const
+{
+    // A file that does not exist yet is none of them.
+    auto target = QFileInfo(fileName).canonicalFilePath();
+    if (target.isEmpty())
+        return false;
+    for (auto &used: { _recordingLoader.fileName(), _journalFileName,
+                       _serialReader.historyFileName() }) {
+        if (!used.isEmpty() && QFileInfo(used).canonicalFilePath() == target)
+            return true;
+    }
+    return false;
+}
+
+bool MainWindow::copyFile(const QString &source, const QString &target)
+{
+    QFile in(source);
+    QSaveFile out(target);
+    if (!in.open(QFile::ReadOnly) || !out.open(QFile::WriteOnly))
+        return false;
+
+    // An uncommitted QSaveFile leaves the target as it was.
+    QByteArray buffer(_copyBlockSize, Qt::Uninitialized);
+    forever {
+        auto size = in.read(buffer.data(), buffer.size());
+        if (size < 0)
+            return false;
+        if (size == 0)
+            break;
+        if (out.write(buffer.constData(), size) != size)
+            return false;
+    }
+    return out.commit();
+}
+
+QString MainWindow::sessionFilePath(const QString &fileName)
 {
     return QDir::toNativeSeparators(currentFileLocation() + "/" +fileName);
 }
 
-void MainWindow::createAudioDirectory()
+void MainWindow::createSessionDirectory()
 {
     _currentSubDir = QDateTime(QDateTime::currentDateTime()).toString("yyyy-MM-dd_hh-mm-ss");
     QDir targetDir(currentFileLocation());
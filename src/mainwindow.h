@@ -21,12 +21,16 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "capturejournal.h"
+#include "datalogmodel.h"
+#include "recordingloader.h"
 #include "serialreader.h"
 
 #include <QAudioDeviceInfo>
 #include <QMap>
 #include <QMainWindow>
 #include <QSerialPortInfo>
+#include <QSet>
 #include <QTimer>
 
 namespace Ui {
@@ -36,7 +40,10 @@ class MainWindow;
 class QActionGroup;
 class QAudioRecorder;
 class QDoubleSpinBox;
+class QLabel;
+class QProgressBar;
 class QSpinBox;
+class QToolButton;
 
 class MainWindow : public QMainWindow
 {
@@ -50,6 +57,8 @@ private slots:
     // File
     void on_actionOpen_CSV_triggered();
     void on_actionExportCSV_triggered();
+    void on_actionSaveSession_triggered();
+    void on_actionSaveStats_triggered();
     void on_actionQuit_triggered();
 
     // Audio
@@ -66,20 +75,31 @@ private slots:
     void on_actionZoom_In_triggered();
     void on_actionZoom_Out_triggered();
     void on_actionReset_Zoom_triggered();
-    void on_actionPulse_triggered();
+    void channelToggled(QAction *action);
+    void on_actionMinMax_triggered();
+    void on_actionRasterPlot_triggered();
+    void on_actionFollow_triggered();
+    void on_actionPipelineStats_triggered();
 
     // Help
     void on_actionAboutQt_triggered();
 
     // Other
     void showNewData(const QByteArray &data);
+    void setupChannels();
     void minXChanged(int value);
     void maxXChanged(int value);
     void minYChanged(int value);
     void maxYChanged(int value);
     void dpEpsilonChanged(double value);
+    void plotAreaChanged(const QRectF &plotArea);
+
+    void showLoadProgress(qint64 bytes, qint64 total);
+    void csvLoaded(bool canceled);
+    void cancelLoad();
 
     void setAxisValues();
+    void showStats();
     void recordAudio();
     void handleAudioInError();
 
@@ -87,6 +107,9 @@ private:
     void setupAxisX();
     void setupAxisY();
     void setupDpEpsilon();
+    void setupLoadProgress();
+    void setupStats();
+    void setupChannelMenu();
 
     void setStandardBaudRates();
     void setSerialPortInfo();
@@ -96,8 +119,31 @@ private:
 
     QString documentsLocation() const;
     QString currentFileLocation() const;
-    QString audioTargetFilePath(const QString &fileName);
-    void createAudioDirectory();
+    QString sessionFilePath(const QString &fileName);
+    void createSessionDirectory();
+
+    /**
+     * @brief The live session's journal or the opened CSV file.
+     */
+    QString csvFileName() const;
+
+    /**
+     * @brief Whether fileName is the opened recording, the journal or the
+     *        history, which are still read or written.
+     */
+    bool isSessionFile(const QString &fileName) const;
+
+    /**
+     * @brief Copies source through a temporary file, so target is only
+     *        replaced by a complete copy.
+     */
+    bool copyFile(const QString &source, const QString &target);
+
+    /**
+     * @brief Logs the latency of the session and saves its histogram next
+     *        to the journal.
+     */
+    void saveLatency();
 
     void appendLog(const QString &log);
 
@@ -112,6 +158,9 @@ private:
     QString _checkedDeviceAction;
     QMap<QString, QSerialPortInfo> _serialPortInfos;
 
+    QMenu *_channelMenu;
+    QSet<QString> _hiddenChannels{ "pulse" };
+
     QMenu *_audioInMenu;
     QActionGroup *_audioInGroup;
     QMap<QString, QAudioDeviceInfo> _audioInInfos;
@@ -119,19 +168,29 @@ private:
     QAudioRecorder *_audioRecorder;
 
     QTimer _timer;
-    const int _timer_msec = 50;
+    const int _timer_msec = 10;
+    const int _frameRate = 30;
+    QTimer _statsTimer;
+    const int _statsTimer_msec = 500;
 
+    const qint64 _memoryBudget = qint64(256) * 1024 * 1024; // 256MiB
     SerialReader _serialReader;
+    RecordingLoader _recordingLoader;
+    CaptureJournal _journal;
+    QString _journalFileName;
 
     const int _initSize = 1024 * 1024 * 8; // 8MiB
-    QByteArray _rawData;
-    QList<QByteArray> _rawLines;
+    const int _copyBlockSize = 1024 * 1024; // 1MiB
+    DataLogModel _dataLogModel;
 
     QSpinBox *_minXSpinBox;
     QSpinBox *_maxXSpinBox;
     QSpinBox *_minYSpinBox;
     QSpinBox *_maxYSpinBox;
     QDoubleSpinBox *_dpEpsilonSpinBox;
+    QProgressBar *_loadProgress;
+    QToolButton *_cancelLoadButton;
+    QLabel *_statsLabel;
 
     QString _currentSubDir;
 };
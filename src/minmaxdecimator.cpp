@@ -0,0 +1,75 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "minmaxdecimator.h"
+
+#include <QtMath>
+
+MinMaxDecimator::MinMaxDecimator()
+{
+
+}
+
+void MinMaxDecimator::decimate(const ChannelView &data, qreal minX, qreal maxX,
+                               int width, QVector<QPointF> &result)
+{
+    result.clear();
+    if (data.isEmpty() || width <= 0 || maxX <= minX)
+        return;
+
+    int first = data.lowerBound(minX);
+    int last = data.upperBound(maxX);
+    first = qMax(first - 1, 0);
+    last = qMin(last, data.size() - 1);
+
+    // Samples left and right of the plot get a column of their own.
+    auto x = data.x();
+    auto y = data.y();
+    auto scale = width / (maxX - minX);
+    auto columnOf = [=](qreal value) {
+        return qFloor(qBound(-1.0, (value - minX) * scale, qreal(width)));
+    };
+
+    int i = first;
+    while (i <= last) {
+        auto column = columnOf(x[i]);
+        int firstIndex = i;
+        int minIndex = i;
+        int maxIndex = i;
+        for (++i; i <= last; ++i) {
+            if (columnOf(x[i]) != column)
+                break;
+            if (y[i] < y[minIndex])
+                minIndex = i;
+            if (y[i] > y[maxIndex])
+                maxIndex = i;
+        }
+        int lastIndex = i - 1;
+
+        int indices[] = { firstIndex, qMin(minIndex, maxIndex),
+                          qMax(minIndex, maxIndex), lastIndex };
+        int previous = -1;
+        for (auto index: indices) {
+            if (index != previous)
+                result.append(data[index]);
+            previous = index;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINMAXDECIMATOR_H
+#define MINMAXDECIMATOR_H
+
+#include "channelview.h"
+
+#include <QVector>
+#include <QPointF>
+
+/**
+ * @brief Pixel-aware min/max (M4) decimation.
+ *
+ * For every pixel column of the plot only the first, minimum, maximum and
+ * last sample are kept. A line drawn through the result covers exactly the
+ * same pixels as one drawn through all samples, while the number of points
+ * is bounded by four times the plot width.
+ *
+ * @remark See Jugel et al., "M4: A Visualization-Oriented Time Series Data
+ *         Aggregation", VLDB 2014.
+ */
+class MinMaxDecimator final
+{
+private:
+    MinMaxDecimator();
+
+public:
+    /**
+     * @brief Decimates the samples of data visible in [minX, maxX].
+     *
+     * data must be sorted by x. The nearest sample on either side of the
+     * visible range is kept as well so lines leave the plot correctly.
+     */
+    static void decimate(const ChannelView &data, qreal minX, qreal maxX,
+                         int width, QVector<QPointF> &result);
+};
+
+#endif // MINMAXDECIMATOR_H
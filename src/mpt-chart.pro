@@ -1,4 +1,4 @@
-QT       += core gui serialport charts multimedia
+QT       += core gui serialport charts multimedia concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -21,17 +21,58 @@ DEFINES += QT_DEPRECATED_WARNINGS
 CONFIG += c++14
 
 SOURCES += \
+        capturejournal.cpp \
+        channelschema.cpp \
+        datalogmodel.cpp \
+        datalogview.cpp \
+        distancekernel.cpp \
         douglaspeucker.cpp \
+        latencyhistogram.cpp \
+        lodpyramid.cpp \
         main.cpp \
         mainwindow.cpp \
+        minmaxdecimator.cpp \
+        pipelinestats.cpp \
+        rasterplotitem.cpp \
         chartview.cpp \
-        serialreader.cpp
+        csvparser.cpp \
+        recordingloader.cpp \
+        renderscheduler.cpp \
+        samplehistory.cpp \
+        samplestore.cpp \
+        serialreader.cpp \
+        serialworker.cpp \
+        sessionfile.cpp \
+        significanceindex.cpp \
+        streamingsimplifier.cpp
 
 HEADERS += \
+        capturejournal.h \
+        channelschema.h \
+        channelview.h \
+        datalogmodel.h \
+        datalogview.h \
+        distancekernel.h \
         douglaspeucker.h \
+        latencyhistogram.h \
+        lodpyramid.h \
         mainwindow.h \
+        minmaxdecimator.h \
+        pipelinestats.h \
+        rasterplotitem.h \
         chartview.h \
-        serialreader.h
+        csvparser.h \
+        recordingloader.h \
+        renderscheduler.h \
+        sample.h \
+        samplehistory.h \
+        samplestore.h \
+        serialreader.h \
+        serialworker.h \
+        sessionfile.h \
+        significanceindex.h \
+        spscqueue.h \
+        streamingsimplifier.h
 
 FORMS += \
         mainwindow.ui
@@ -0,0 +1,178 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "pipelinestats.h"
+
+#include <QFile>
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Nearest rank of the percentile p of n sorted values.
+int rank(qreal p, int n)
+{
+    return qBound(0, static_cast<int>(std::ceil(p * n)) - 1, n - 1);
+}
+
+} // namespace
+
+PipelineStats::Tick::Tick(PipelineStats *stats, Stage stage, bool running)
+    : _stats(stats && stats->isEnabled() ? stats : nullptr)
+    , _stage(stage)
+{
+    if (running)
+        start();
+}
+
+PipelineStats::Tick::~Tick()
+{
+    if (!_stats)
+        return;
+    stop();
+    _stats->record(_stage, _nsecs, _in, _out);
+}
+
+void PipelineStats::Tick::start()
+{
+    if (_stats && !_timer.isValid())
+        _timer.start();
+}
+
+void PipelineStats::Tick::stop()
+{
+    if (!_stats || !_timer.isValid())
+        return;
+    _nsecs += _timer.nsecsElapsed();
+    _timer.invalidate();
+}
+
+const char* PipelineStats::name(Stage stage)
+{
+    switch (stage) {
+    case Read:
+        return "read";
+    case Ingest:
+        return "ingest";
+    case Simplify:
+        return "simplify";
+    case Update:
+        return "update";
+    case Paint:
+        return "paint";
+    default:
+        return "";
+    }
+}
+
+void PipelineStats::clear()
+{
+    for (auto &ring: _rings)
+        ring.ticks.store(0, std::memory_order_release);
+}
+
+void PipelineStats::record(Stage stage, qint64 nsecs, qint64 pointsIn, qint64 pointsOut)
+{
+    auto &ring = _rings[stage];
+    auto ticks = ring.ticks.load(std::memory_order_relaxed);
+    auto &entry = ring.entries[ticks % Window];
+    entry.nsecs.store(nsecs, std::memory_order_relaxed);
+    entry.pointsIn.store(pointsIn, std::memory_order_relaxed);
+    entry.pointsOut.store(pointsOut, std::memory_order_relaxed);
+    ring.ticks.store(ticks + 1, std::memory_order_release);
+}
+
+PipelineStats::Summary PipelineStats::summary(Stage stage) const
+{
+    // A tick recorded meanwhile may replace an entry being read; that is
+    // still a valid tick of the window.
+    auto &ring = _rings[stage];
+    Summary summary;
+    summary.ticks = static_cast<int>(qMin(ring.ticks.load(std::memory_order_acquire),
+                                          quint64(Window)));
+    if (summary.ticks == 0)
+        return summary;
+
+    qint64 nsecs[Window];
+    qint64 pointsIn = 0;
+    qint64 pointsOut = 0;
+    for (int i=0; i<summary.ticks; ++i) {
+        auto &entry = ring.entries[i];
+        nsecs[i] = entry.nsecs.load(std::memory_order_relaxed);
+        pointsIn += entry.pointsIn.load(std::memory_order_relaxed);
+        pointsOut += entry.pointsOut.load(std::memory_order_relaxed);
+    }
+
+    auto end = nsecs + summary.ticks;
+    auto median = nsecs + rank(0.5, summary.ticks);
+    std::nth_element(nsecs, median, end);
+    summary.p50 = *median / 1e6;
+    auto p99 = nsecs + rank(0.99, summary.ticks);
+    std::nth_element(median, p99, end);
+    summary.p99 = *p99 / 1e6;
+    summary.pointsIn = static_cast<qreal>(pointsIn) / summary.ticks;
+    summary.pointsOut = static_cast<qreal>(pointsOut) / summary.ticks;
+    return summary;
+}
+
+QString PipelineStats::toString() const
+{
+    QStringList stages;
+    for (int i=0; i<StageCount; ++i) {
+        auto stage = static_cast<Stage>(i);
+        auto summary = this->summary(stage);
+        if (summary.ticks == 0)
+            continue;
+        auto text = QString("%1 %2/%3 ms").arg(name(stage))
+                .arg(summary.p50, 0, 'f', 2)
+                .arg(summary.p99, 0, 'f', 2);
+        if (summary.pointsIn > 0 || summary.pointsOut > 0)
+            text += QString(" %1%2%3").arg(qRound64(summary.pointsIn))
+                    .arg(QChar(0x2192))
+                    .arg(qRound64(summary.pointsOut));
+        stages.append(text);
+    }
+    return stages.join("  ");
+}
+
+bool PipelineStats::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return false;
+
+    QByteArray data("stage,tick,nsecs,pointsIn,pointsOut\n");
+    for (int i=0; i<StageCount; ++i) {
+        auto &ring = _rings[i];
+        auto ticks = ring.ticks.load(std::memory_order_acquire);
+        auto first = ticks > quint64(Window) ? ticks - Window : 0;
+        for (auto tick=first; tick<ticks; ++tick) {
+            auto &entry = ring.entries[tick % Window];
+            data.append(name(static_cast<Stage>(i))).append(',')
+                    .append(QByteArray::number(tick)).append(',')
+                    .append(QByteArray::number(entry.nsecs.load(std::memory_order_relaxed))).append(',')
+                    .append(QByteArray::number(entry.pointsIn.load(std::memory_order_relaxed))).append(',')
+                    .append(QByteArray::number(entry.pointsOut.load(std::memory_order_relaxed))).append('\n');
+        }
+    }
+    return file.write(data) == data.size() && file.flush();
+}
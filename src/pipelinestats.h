@@ -0,0 +1,163 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <atomic>
+
+/**
+ * @brief Per-tick durations and point counts of the acquisition and
+ *        drawing stages.
+ *
+ * Every stage keeps its last Window ticks in a ring, from which the median
+ * and the 99th percentile are taken. A stage is written by a single thread
+ * only, the worker's one by the acquisition thread, all others by the GUI
+ * thread; the rings are lock-free, so they may be summarized at any time.
+ *
+ * Nothing is measured while disabled; a Tick then costs a single load.
+ */
+class PipelineStats final
+{
+public:
+    enum Stage {
+        Read,       ///< Reading and parsing on the acquisition thread
+        Ingest,     ///< Storing the samples and updating the indices
+        Simplify,   ///< Simplifying or decimating the visible samples
+        Update,     ///< Handing the points to the series or raster item
+        Paint,      ///< Painting the chart
+        StageCount
+    };
+
+    /**
+     * @brief Summary of the ticks of a stage in the window.
+     */
+    struct Summary {
+        int ticks = 0;
+        qreal p50 = 0.0;        ///< Median duration in ms
+        qreal p99 = 0.0;        ///< 99th percentile of the duration in ms
+        qreal pointsIn = 0.0;   ///< Mean points taken per tick
+        qreal pointsOut = 0.0;  ///< Mean points produced per tick
+    };
+
+    /**
+     * @brief Measures a tick of a stage, possibly in several parts.
+     *
+     * The tick is recorded when it goes out of scope.
+     */
+    class Tick final
+    {
+    public:
+        Tick(PipelineStats *stats, Stage stage, bool running = true);
+        ~Tick();
+
+        Tick(const Tick &) = delete;
+        Tick& operator=(const Tick &) = delete;
+
+        void start();
+        void stop();
+
+        void addPoints(qint64 in, qint64 out) {
+            _in += in;
+            _out += out;
+        }
+
+        /**
+         * @brief Leaves the tick unrecorded, e.g. if there was nothing to
+         *        do.
+         */
+        void discard() {
+            _stats = nullptr;
+        }
+
+    private:
+        PipelineStats *_stats;
+        Stage _stage;
+        QElapsedTimer _timer;
+        qint64 _nsecs = 0;
+        qint64 _in = 0;
+        qint64 _out = 0;
+    };
+
+    /**
+     * @brief Ticks per stage that the summaries cover.
+     */
+    static const int Window = 256;
+
+    PipelineStats() = default;
+    PipelineStats(const PipelineStats &) = delete;
+    PipelineStats& operator=(const PipelineStats &) = delete;
+
+    static const char* name(Stage stage);
+
+    bool isEnabled() const {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Starts or stops measuring; the recorded ticks are kept.
+     */
+    void setEnabled(bool enabled) {
+        _enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops the recorded ticks of all stages.
+     *
+     * Must not run concurrently with record().
+     */
+    void clear();
+
+    void record(Stage stage, qint64 nsecs, qint64 pointsIn = 0, qint64 pointsOut = 0);
+
+    Summary summary(Stage stage) const;
+
+    /**
+     * @brief One line for the status bar, e.g. "simplify 0.31/1.20 ms
+     *        4000→120" per stage with ticks.
+     */
+    QString toString() const;
+
+    /**
+     * @brief Writes the ticks of every stage in the window as CSV, oldest
+     *        first.
+     */
+    bool save(const QString &fileName) const;
+
+private:
+    struct Entry {
+        std::atomic<qint64> nsecs{0};
+        std::atomic<qint64> pointsIn{0};
+        std::atomic<qint64> pointsOut{0};
+    };
+
+    struct Ring {
+        std::atomic<quint64> ticks{0};
+        Entry entries[Window];
+    };
+
+    std::atomic<bool> _enabled{false};
+    Ring _rings[StageCount];
+};
+
+#endif // PIPELINESTATS_H
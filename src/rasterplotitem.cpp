@@ -0,0 +1,203 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "rasterplotitem.h"
+
+#include <QChart>
+#include <QValueAxis>
+#include <QWidget>
+#include <QXYSeries>
+#include <QtMath>
+
+#include <algorithm>
+
+RasterPlotItem::RasterPlotItem(QChart *chart, QValueAxis *axisX, QValueAxis *axisY)
+    : QGraphicsObject(chart)
+    , _axisX(axisX)
+    , _axisY(axisY)
+{
+    // The chart stacks grid, series and legend with small z values; the
+    // channels are drawn above all of them.
+    setZValue(ZValue);
+    setPlotArea(chart->plotArea());
+    connect(chart, &QChart::plotAreaChanged, this, &RasterPlotItem::setPlotArea);
+
+    // Whether a pixmap can be scrolled is decided when it is painted.
+    connect(axisX, &QValueAxis::rangeChanged, this, [this] { update(); });
+    connect(axisY, &QValueAxis::rangeChanged, this, [this] { update(); });
+}
+
+void RasterPlotItem::setSeries(const QVector<QXYSeries*> &series)
+{
+    _layers.resize(series.size());
+    for (int i=0; i<_layers.size(); ++i) {
+        _layers[i].series = series[i];
+        _layers[i].points.clear();
+        _layers[i].changedX = -std::numeric_limits<qreal>::infinity();
+    }
+    update();
+}
+
+void RasterPlotItem::setPoints(int layer, const QVector<QPointF> &points, int unchanged)
+{
+    // Copied into the layer's own buffer; sharing points would make the
+    // caller's next update of them allocate a copy. Only the tail is
+    // copied, so a long session does not make every frame more expensive.
+    auto &target = _layers[layer].points;
+    unchanged = qBound(0, unchanged, qMin(target.size(), points.size()));
+    target.resize(points.size());
+    std::copy(points.cbegin() + unchanged, points.cend(), target.begin() + unchanged);
+
+    // The segment ending in the first new point changed as well.
+    auto changedX = unchanged > 0 ? points[unchanged-1].x()
+                                  : -std::numeric_limits<qreal>::infinity();
+    _layers[layer].changedX = qMin(_layers[layer].changedX, changedX);
+    update();
+}
+
+QRectF RasterPlotItem::boundingRect() const
+{
+    return QRectF(QPointF(0.0, 0.0), _plotArea.size());
+}
+
+void RasterPlotItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+                           QWidget *widget)
+{
+    Q_UNUSED(option)
+
+    auto view = currentView(widget ? widget->devicePixelRatioF() : 1.0);
+    if (view.maxX <= view.minX || view.maxY <= view.minY)
+        return;
+
+    auto scaleX = _plotArea.width() / (view.maxX - view.minX);
+    for (auto &layer: _layers) {
+        if (layer.points.isEmpty())
+            continue;
+        render(layer, view, painter->renderHints());
+
+        // A scrolled pixmap lags behind by less than a pixel.
+        auto offset = (layer.view.minX - view.minX) * scaleX;
+        painter->drawPixmap(QPointF(offset, 0.0), layer.pixmap);
+    }
+}
+
+void RasterPlotItem::setPlotArea(const QRectF &plotArea)
+{
+    prepareGeometryChange();
+    _plotArea = plotArea;
+    setPos(plotArea.topLeft());
+}
+
+RasterPlotItem::View RasterPlotItem::currentView(qreal devicePixelRatio) const
+{
+    View view;
+    view.minX = _axisX->min();
+    view.maxX = _axisX->max();
+    view.minY = _axisY->min();
+    view.maxY = _axisY->max();
+    view.size = (_plotArea.size() * devicePixelRatio).toSize();
+    view.devicePixelRatio = devicePixelRatio;
+    return view;
+}
+
+void RasterPlotItem::render(Layer &layer, const View &view, QPainter::RenderHints hints)
+{
+    qreal fromX;
+    if (!scroll(layer, view, fromX)) {
+        if (layer.pixmap.size() != view.size)
+            layer.pixmap = QPixmap(view.size);
+        layer.pixmap.setDevicePixelRatio(view.devicePixelRatio);
+        layer.view = view;
+        fromX = -std::numeric_limits<qreal>::infinity();
+    }
+    if (fromX < layer.view.maxX)
+        draw(layer, fromX, hints);
+    layer.changedX = std::numeric_limits<qreal>::infinity();
+}
+
+bool RasterPlotItem::scroll(Layer &layer, const View &view, qreal &fromX)
+{
+    auto &old = layer.view;
+    if (!_scrolling || layer.pixmap.isNull() ||
+            layer.changedX == -std::numeric_limits<qreal>::infinity() ||
+            old.size != view.size || old.devicePixelRatio != view.devicePixelRatio ||
+            old.minY != view.minY || old.maxY != view.maxY ||
+            !qFuzzyCompare(old.maxX - old.minX, view.maxX - view.minX) ||
+            view.minX < old.minX)
+        return false;
+
+    // Shifted by whole pixels only, so the kept part stays sharp.
+    auto pixels = view.size.width() / (old.maxX - old.minX);
+    auto shift = qFloor((view.minX - old.minX) * pixels);
+    if (shift >= view.size.width())
+        return false;
+
+    fromX = qMin(layer.changedX, old.maxX);
+    if (shift > 0) {
+        layer.pixmap.scroll(-shift, 0, layer.pixmap.rect());
+        old.minX += shift / pixels;
+        old.maxX += shift / pixels;
+    }
+    return true;
+}
+
+void RasterPlotItem::draw(Layer &layer, qreal fromX, QPainter::RenderHints hints)
+{
+    auto &view = layer.view;
+    auto width = _plotArea.width();
+    auto height = _plotArea.height();
+    auto scaleX = width / (view.maxX - view.minX);
+    auto scaleY = height / (view.maxY - view.minY);
+    auto pen = layer.series->pen();
+
+    // The strip starts a pen width early, so the end of the line drawn
+    // before is replaced as well.
+    auto left = 0.0;
+    if (fromX > view.minX)
+        left = qMax(0.0, qFloor((fromX - view.minX) * scaleX) - qMax(1.0, pen.widthF()));
+    QRectF strip(left, 0.0, width - left, height);
+
+    QPainter painter(&layer.pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(strip, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(strip);
+    painter.setRenderHints(hints);
+    painter.setPen(pen);
+
+    // Only the points in the strip and their neighbours outside are mapped.
+    auto &points = layer.points;
+    auto compareX = [](const QPointF &point, qreal x) {
+        return point.x() < x;
+    };
+    auto first = std::lower_bound(points.cbegin(), points.cend(),
+                                  view.minX + left / scaleX, compareX);
+    auto last = std::lower_bound(first, points.cend(), view.maxX, compareX);
+    if (first != points.cbegin())
+        --first;
+    if (last != points.cend())
+        ++last;
+
+    _polyline.resize(0);
+    for (auto point=first; point!=last; ++point)
+        _polyline.append(QPointF((point->x() - view.minX) * scaleX,
+                                 height - (point->y() - view.minY) * scaleY));
+    painter.drawPolyline(_polyline);
+}
@@ -0,0 +1,134 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RASTERPLOTITEM_H
+#define RASTERPLOTITEM_H
+
+#include <QChartGlobal>
+#include <QGraphicsObject>
+#include <QPainter>
+#include <QPixmap>
+#include <QPointF>
+#include <QPolygonF>
+#include <QVector>
+
+#include <limits>
+
+QT_CHARTS_BEGIN_NAMESPACE
+class QChart;
+class QValueAxis;
+class QXYSeries;
+QT_CHARTS_END_NAMESPACE
+
+QT_CHARTS_USE_NAMESPACE
+
+/**
+ * @brief Draws the channels into the plot area of a chart in place of
+ *        their line series.
+ *
+ * The points of a channel are taken as they are, already decimated, and
+ * painted into a pixmap of their own. The pixmap is reused by every paint
+ * until the points of its channel, the axis ranges or the plot area
+ * change, so neither repaints nor the other channels redraw a polyline.
+ * The series only lend their pen and name; they stay empty.
+ *
+ * While scrolling, a view that only moved to the right keeps its pixmap:
+ * the pixmap is shifted by whole pixels and only the newly exposed strip
+ * and the points changed since the last paint are drawn. Zooming, resizing
+ * or changing the y axis draws everything again.
+ */
+class RasterPlotItem : public QGraphicsObject
+{
+    Q_OBJECT
+
+public:
+    RasterPlotItem(QChart *chart, QValueAxis *axisX, QValueAxis *axisY);
+
+    /**
+     * @brief Creates a layer per series, drawn with its pen.
+     */
+    void setSeries(const QVector<QXYSeries*> &series);
+
+    /**
+     * @brief Replaces the points of a layer; they have to be sorted by x.
+     *
+     * The first unchanged points have to be the same as before; only the
+     * points after them are copied, and the layer is drawn again from the
+     * last unchanged point on. By default the layer is replaced and drawn
+     * again as a whole.
+     */
+    void setPoints(int layer, const QVector<QPointF> &points, int unchanged = 0);
+
+    bool isScrolling() const {
+        return _scrolling;
+    }
+
+    void setScrolling(bool scrolling) {
+        _scrolling = scrolling;
+    }
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget) override;
+
+private slots:
+    void setPlotArea(const QRectF &plotArea);
+
+private:
+    /**
+     * @brief Axis ranges and pixmap size a pixmap was drawn for.
+     */
+    struct View {
+        qreal minX = 0.0;
+        qreal maxX = 0.0;
+        qreal minY = 0.0;
+        qreal maxY = 0.0;
+        QSize size;
+        qreal devicePixelRatio = 1.0;
+    };
+
+    struct Layer {
+        QXYSeries *series = nullptr;
+        QVector<QPointF> points;
+        QPixmap pixmap;
+        View view;
+
+        /**
+         * @brief The pixmap shows the points before this x.
+         */
+        qreal changedX = -std::numeric_limits<qreal>::infinity();
+    };
+
+    static constexpr qreal ZValue = 100.0;
+
+    View currentView(qreal devicePixelRatio) const;
+    void render(Layer &layer, const View &view, QPainter::RenderHints hints);
+    bool scroll(Layer &layer, const View &view, qreal &fromX);
+    void draw(Layer &layer, qreal fromX, QPainter::RenderHints hints);
+
+    QValueAxis *_axisX;
+    QValueAxis *_axisY;
+    QRectF _plotArea;
+    bool _scrolling = false;
+    QVector<Layer> _layers;
+    QPolygonF _polyline;
+};
+
+#endif // RASTERPLOTITEM_H
@@ -0,0 +1,182 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "recordingloader.h"
+#include "csvparser.h"
+
+#include <QtConcurrent>
+
+#include <cstring>
+#include <limits>
+
+RecordingLoader::RecordingLoader(QObject *parent)
+    : QObject(parent)
+{
+
+}
+
+RecordingLoader::~RecordingLoader()
+{
+    close();
+}
+
+bool RecordingLoader::open(const QString &fileName)
+{
+    close();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QFile::ReadOnly)) {
+        _errorString = QString("Could not open file %1: %2")
+                .arg(fileName).arg(_file.errorString());
+        return false;
+    }
+
+    // data() is a QByteArray, which is limited to int.
+    _size = _file.size();
+    if (_size > std::numeric_limits<int>::max()) {
+        _errorString = QString("File %1 is too large.").arg(fileName);
+        close();
+        return false;
+    }
+    if (_size > 0) {
+        _data = reinterpret_cast<const char*>(_file.map(0, _size));
+        if (!_data) {
+            _errorString = QString("Could not map file %1: %2")
+                    .arg(fileName).arg(_file.errorString());
+            close();
+            return false;
+        }
+    }
+
+    _isSession = SessionFile::isSession(_data, _size);
+    if (_isSession && !_session.open(_data, _size)) {
+        _errorString = QString("Could not read session %1: %2")
+                .arg(fileName).arg(_session.errorString());
+        close();
+        return false;
+    }
+
+    _schema = ChannelSchema();
+    if (_isSession) {
+        _schema = _session.schema();
+    } else if (_size > 0) {
+        auto newline = static_cast<const char*>(memchr(_data, '\n', static_cast<size_t>(_size)));
+        ChannelSchema::fromHeader(_data, newline ? newline : _data + _size, _schema);
+    }
+
+    _errorString.clear();
+    if (_isSession)
+        return true;
+    _canceled = false;
+    auto generation = ++_generation;
+    _future = QtConcurrent::run([this, generation] { parse(generation); });
+    return true;
+}
+
+void RecordingLoader::cancel()
+{
+    _canceled = true;
+    _future.waitForFinished();
+    ++_generation;
+}
+
+void RecordingLoader::close()
+{
+    cancel();
+    if (_data)
+        _file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(_data)));
+    _data = nullptr;
+    _size = 0;
+    _isSession = false;
+    _session.close();
+    _file.close();
+}
+
+bool RecordingLoader::isLoading() const
+{
+    return _future.isRunning();
+}
+
+QByteArray RecordingLoader::data() const
+{
+    if (_isSession)
+        return QByteArray();
+    return QByteArray::fromRawData(_data, static_cast<int>(_size));
+}
+
+void RecordingLoader::parse(int generation)
+{
+    // Runs on the thread pool; everything is posted to the GUI thread and
+    // emitted there unless the load was canceled in the meantime.
+    auto post = [this, generation](std::function<void()> emitter) {
+        QMetaObject::invokeMethod(this, [this, generation, emitter] {
+            if (generation == _generation)
+                emitter();
+        }, Qt::QueuedConnection);
+    };
+
+    auto total = _size;
+    auto emitSamples = [this, post, total](const QVector<Sample> &samples, qint64 bytes) {
+        post([this, samples, bytes, total] {
+            emit samplesLoaded(samples);
+            emit progress(bytes, total);
+        });
+    };
+
+    parseCsv(emitSamples);
+
+    auto canceled = _canceled.load();
+    post([this, canceled] { emit finished(canceled); });
+}
+
+void RecordingLoader::parseCsv(const SampleSink &emitSamples)
+{
+    auto begin = _data;
+    auto end = _data + _size;
+    auto chunkSize = FirstChunkSize;
+    while (begin < end && !_canceled) {
+        auto chunkEnd = end - begin > chunkSize ? begin + chunkSize : end;
+
+        QVector<Sample> samples;
+        Sample sample;
+        auto parseLine = [&](const char *lineBegin, const char *lineEnd) {
+            if (CsvParser::parse(lineBegin, lineEnd, _schema.count(), sample))
+                samples.append(sample);
+        };
+        auto rest = CsvParser::forEachLine(begin, chunkEnd, parseLine);
+        if (chunkEnd == end && rest < end) {
+            parseLine(rest, end);
+            rest = end;
+        }
+
+        if (rest == begin) {
+            // Not even one line fits; try again with a larger chunk.
+            chunkSize *= 2;
+            continue;
+        }
+        begin = rest;
+
+        // Small chunks first for a quick first view, larger ones later, so
+        // refreshing the view after every chunk stays cheap in total.
+        chunkSize = qMin(2 * chunkSize, qint64(MaxChunkSize));
+
+        emitSamples(samples, static_cast<qint64>(begin - _data));
+    }
+}
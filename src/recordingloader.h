@@ -0,0 +1,139 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RECORDINGLOADER_H
+#define RECORDINGLOADER_H
+
+#include "channelschema.h"
+#include "sample.h"
+#include "sessionfile.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Loads a CSV recording or a session on a background thread.
+ *
+ * The file is memory-mapped instead of read, so its bytes are neither
+ * copied nor held on the heap; data() exposes the mapping of a CSV file.
+ * The rows are parsed in chunks of growing size and handed over chunk by
+ * chunk, so the first part of a large file can be shown almost immediately
+ * while the rest is still being parsed. Of a session only the index is read
+ * by open(); its chunks are decoded on demand through session(), so a
+ * session is not loaded at all.
+ */
+class RecordingLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RecordingLoader(QObject *parent = nullptr);
+    ~RecordingLoader();
+
+    /**
+     * @brief Maps fileName and starts parsing it unless it is a session; a
+     *        running load is canceled first.
+     */
+    bool open(const QString &fileName);
+
+    /**
+     * @brief Stops parsing and waits for the background thread; no more
+     *        signals of the current load are emitted afterwards.
+     */
+    void cancel();
+
+    /**
+     * @brief Cancels and unmaps the file; data() must not be used anymore.
+     */
+    void close();
+
+    bool isLoading() const;
+
+    /**
+     * @brief The mapped CSV file without a copy; empty for a session.
+     */
+    QByteArray data() const;
+
+    bool isSession() const {
+        return _isSession;
+    }
+
+    /**
+     * @brief The channels of the opened file; a CSV file without header is
+     *        taken for the default schema.
+     */
+    const ChannelSchema& schema() const {
+        return _schema;
+    }
+
+    /**
+     * @brief The index of an opened session; valid until close() or the
+     *        next open().
+     */
+    const SessionReader& session() const {
+        return _session;
+    }
+
+    QString fileName() const {
+        return _file.fileName();
+    }
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+signals:
+    void samplesLoaded(const QVector<Sample> &samples);
+    void progress(qint64 bytes, qint64 total);
+    void finished(bool canceled);
+
+private:
+    static const qint64 FirstChunkSize = 1 << 20;
+    static const qint64 MaxChunkSize = 1 << 25;
+
+    // Hands over the parsed samples and the number of bytes done.
+    using SampleSink = std::function<void(const QVector<Sample>&, qint64)>;
+
+    void parse(int generation);
+    void parseCsv(const SampleSink &emitSamples);
+
+    QFile _file;
+    const char *_data = nullptr;
+    qint64 _size = 0;
+    bool _isSession = false;
+    ChannelSchema _schema;
+    SessionReader _session;
+    QString _errorString;
+
+    // Signals are queued to the GUI thread; those of a canceled load are
+    // recognized by an outdated generation and dropped.
+    int _generation = 0;
+    std::atomic<bool> _canceled{false};
+    QFuture<void> _future;
+};
+
+#endif // RECORDINGLOADER_H
@@ -0,0 +1,86 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "renderscheduler.h"
+
+#include <QtMath>
+
+RenderScheduler::RenderScheduler(QObject *parent)
+    : QObject(parent)
+{
+    updateInterval();
+    connect(&_timer, &QTimer::timeout, this, &RenderScheduler::renderFrame);
+}
+
+void RenderScheduler::setFrameRate(int frameRate)
+{
+    _frameRate = qMax(1, frameRate);
+    updateInterval();
+}
+
+void RenderScheduler::requestRender()
+{
+    _pending = true;
+    if (_timer.isActive())
+        return;
+
+    // The first frame after a pause is rendered right away. From then on
+    // the timer keeps running at the interval until a frame finds nothing
+    // to render, so it is not registered again for every frame.
+    auto wait = _lastFrame.isValid()
+            ? qMax(qint64(0), _interval - _lastFrame.elapsed()) : qint64(0);
+    _timer.start(static_cast<int>(wait));
+}
+
+void RenderScheduler::frameRendered(qreal cost)
+{
+    // Smoothed, so a single slow frame does not halve the frame rate.
+    _cost += (cost - _cost) / 4.0;
+    updateInterval();
+}
+
+void RenderScheduler::framePainted(qreal cost)
+{
+    _paintCost += (cost - _paintCost) / 4.0;
+    updateInterval();
+}
+
+void RenderScheduler::renderFrame()
+{
+    if (!_pending) {
+        _timer.stop();
+        return;
+    }
+    _pending = false;
+    _lastFrame.start();
+
+    QElapsedTimer cost;
+    cost.start();
+    emit render();
+    frameRendered(cost.nsecsElapsed() / 1e6);
+    if (_timer.interval() != _interval)
+        _timer.start(_interval);
+}
+
+void RenderScheduler::updateInterval()
+{
+    auto target = qCeil(1000.0 / _frameRate);
+    _interval = qBound(target, qCeil(2.0 * (_cost + _paintCost)), int(MaxInterval));
+}
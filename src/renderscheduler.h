@@ -0,0 +1,120 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief Coalesces render requests into frames at a limited frame rate.
+ *
+ * Any number of requestRender() calls between two frames result in a
+ * single render() signal. The interval between frames follows the
+ * measured cost of render() plus the cost of the paint that shows it, as
+ * reported by framePainted(): a frame may take up to half of its
+ * interval, the other half is left to input and reading. If rendering or
+ * painting gets more expensive than that, the frame rate drops below the
+ * target until it gets cheaper again. The data keeps arriving at its own
+ * rate meanwhile.
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RenderScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Target frame rate in frames per second.
+     */
+    int frameRate() const {
+        return _frameRate;
+    }
+
+    void setFrameRate(int frameRate);
+
+    /**
+     * @brief Current interval between two frames in ms.
+     */
+    int interval() const {
+        return _interval;
+    }
+
+    /**
+     * @brief Smoothed cost of render() in ms.
+     */
+    qreal cost() const {
+        return _cost;
+    }
+
+    /**
+     * @brief Smoothed cost of painting a frame in ms.
+     */
+    qreal paintCost() const {
+        return _paintCost;
+    }
+
+    /**
+     * @brief Schedules a frame, unless one is pending anyway.
+     */
+    void requestRender();
+
+    /**
+     * @brief Adapts the interval to a frame that took cost ms.
+     */
+    void frameRendered(qreal cost);
+
+    /**
+     * @brief Adapts the interval to a paint that took cost ms.
+     *
+     * Painting happens after render() with the next update of the view,
+     * so its cost is reported separately.
+     */
+    void framePainted(qreal cost);
+
+signals:
+    void render();
+
+private slots:
+    void renderFrame();
+
+private:
+    /**
+     * @brief Even the most expensive frames are rendered at least once per
+     *        MaxInterval ms.
+     */
+    static const int MaxInterval = 1000;
+
+    void updateInterval();
+
+    int _frameRate = 30;
+    int _interval = 0;
+    qreal _cost = 0.0;
+    qreal _paintCost = 0.0;
+    bool _pending = false;
+
+    QTimer _timer;
+    QElapsedTimer _lastFrame;
+};
+
+#endif // RENDERSCHEDULER_H
@@ -0,0 +1,45 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <QtGlobal>
+
+/**
+ * @brief One row of the device output: ms,sync and one value per channel.
+ *
+ * The values have room for MaxChannels channels; how many of them are used
+ * and what they are called is given by the ChannelSchema of the session.
+ * The fixed size keeps samples trivially copyable, so they still pass
+ * through the queues and files without allocating.
+ */
+struct Sample
+{
+    static const int MaxChannels = 16;
+
+    qreal ms = 0.0;
+    int sync = 0;
+    int values[MaxChannels] = {};
+};
+
+Q_DECLARE_TYPEINFO(Sample, Q_PRIMITIVE_TYPE);
+
+#endif // SAMPLE_H
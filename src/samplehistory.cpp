@@ -0,0 +1,169 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "samplehistory.h"
+
+#include <QThread>
+
+SampleHistory::SampleHistory()
+    : _queue(QueueCapacity)
+{
+
+}
+
+SampleHistory::~SampleHistory()
+{
+    clear();
+}
+
+bool SampleHistory::open(const QString &fileName, const ChannelSchema &schema)
+{
+    clear();
+
+    // Opening is checked here, the chunks are written on the writer thread.
+    if (!_writer.open(fileName, schema)) {
+        _errorString = _writer.errorString();
+        return false;
+    }
+    _fileName = fileName;
+    _errorString.clear();
+    _stop = false;
+    _failed = false;
+    _thread.reset(QThread::create([this] { write(); }));
+    _thread->setObjectName("SampleHistory");
+    _thread->start(QThread::LowPriority);
+    return true;
+}
+
+void SampleHistory::close()
+{
+    if (!_thread)
+        return;
+
+    // Whatever append() held back is written as well, unless writing
+    // failed already.
+    while (_spilled < _spill.size() && !_failed) {
+        if (_queue.push(_spill[_spilled]))
+            ++_spilled;
+        else
+            QThread::msleep(IdleInterval);
+    }
+    _spill.clear();
+    _spilled = 0;
+
+    _stop = true;
+    _thread->wait();
+    _thread.reset();
+
+    // The writer ends with the rest of the samples and the index.
+    auto failed = _failed.load();
+    if (_writer.close() && !failed)
+        _written = _appended;
+    else
+        _errorString = _writer.errorString();
+}
+
+void SampleHistory::clear()
+{
+    close();
+    _reader.close();
+    if (_map)
+        _file.unmap(_map);
+    _map = nullptr;
+    _mappedSize = 0;
+    _file.close();
+    _fileName.clear();
+    _appended = 0;
+    _written = 0;
+}
+
+bool SampleHistory::append(const Sample &sample)
+{
+    if (!_thread)
+        return false;
+    if (_failed) {
+        close();
+        return false;
+    }
+    ++_appended;
+
+    // Held back samples go first, so the order is kept.
+    while (_spilled < _spill.size() && _queue.push(_spill[_spilled]))
+        ++_spilled;
+    if (_spilled == _spill.size()) {
+        _spill.resize(0);
+        _spilled = 0;
+        if (_queue.push(sample))
+            return true;
+    }
+    _spill.append(sample);
+    return true;
+}
+
+void SampleHistory::write()
+{
+    auto appended = _written.load();
+    Sample sample;
+    forever {
+        // Read the flag first, so nothing appended before close() is lost.
+        auto stop = _stop.load();
+        auto idle = true;
+        while (_queue.pop(sample)) {
+            idle = false;
+            if (!_writer.append(sample)) {
+                _failed = true;
+                return;
+            }
+
+            // The writer writes whole chunks only.
+            if (++appended % SessionFile::ChunkSize == 0)
+                _written = appended;
+        }
+        if (stop)
+            break;
+        if (idle)
+            QThread::msleep(IdleInterval);
+    }
+}
+
+const SessionReader& SampleHistory::reader()
+{
+    if (_fileName.isEmpty())
+        return _reader;
+
+    if (!_file.isOpen()) {
+        _file.setFileName(_fileName);
+        if (!_file.open(QFile::ReadOnly))
+            return _reader;
+    }
+
+    auto size = _file.size();
+    if (size == _mappedSize)
+        return _reader;
+
+    _reader.close();
+    if (_map)
+        _file.unmap(_map);
+    _map = _file.map(0, size);
+    _mappedSize = _map ? size : 0;
+    if (_map)
+        _reader.open(reinterpret_cast<const char*>(_map), size);
+    return _reader;
+}
@@ -0,0 +1,137 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include "sample.h"
+#include "sessionfile.h"
+#include "spscqueue.h"
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <memory>
+
+class QThread;
+
+/**
+ * @brief Disk-backed history of all samples of a live session.
+ *
+ * Every sample is appended to a session file, so the samples in memory
+ * can be dropped once they are written. Older parts are paged in through
+ * reader(), which maps the file again whenever it has grown; only the
+ * chunks actually read are touched. Closing completes the file with its
+ * index and leaves it as a regular recording.
+ *
+ * Like CaptureJournal, append() only queues the sample; a writer thread
+ * of its own writes the chunks, so the caller never waits for the disk.
+ * While the queue is full, samples are held back in memory instead of
+ * being dropped, since written() has to count every sample before it.
+ */
+class SampleHistory final
+{
+public:
+    SampleHistory();
+    ~SampleHistory();
+
+    bool open(const QString &fileName, const ChannelSchema &schema);
+
+    /**
+     * @brief Completes the session file; what was written stays readable.
+     */
+    void close();
+
+    /**
+     * @brief Closes and forgets the history; the file itself is kept.
+     */
+    void clear();
+
+    /**
+     * @brief Whether samples are still being appended.
+     *
+     * A failed write closes the history with the next append(), so
+     * nothing is dropped from memory that is not on disk.
+     */
+    bool isOpen() const {
+        return _thread != nullptr;
+    }
+
+    /**
+     * @brief Called by a single producer thread; never blocks.
+     */
+    bool append(const Sample &sample);
+
+    /**
+     * @brief Number of samples that have been written and can be read.
+     */
+    qint64 written() const {
+        return _written;
+    }
+
+    QString fileName() const {
+        return _fileName;
+    }
+
+    /**
+     * @brief The chunks written so far.
+     */
+    const SessionReader& reader();
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+private:
+    static const int QueueCapacity = 1 << 16;
+    static const int IdleInterval = 20;
+
+    void write();
+
+    QString _fileName;
+    QString _errorString;
+    qint64 _appended = 0;
+    std::atomic<qint64> _written{0};
+
+    /**
+     * @brief Only used by the writer thread while it runs.
+     */
+    SessionWriter _writer;
+    std::unique_ptr<QThread> _thread;
+    std::atomic<bool> _stop{false};
+    std::atomic<bool> _failed{false};
+    SpscQueue<Sample> _queue;
+
+    /**
+     * @brief Samples that did not fit into the queue; the ones before
+     *        _spilled are queued already.
+     */
+    QVector<Sample> _spill;
+    int _spilled = 0;
+
+    QFile _file;
+    uchar *_map = nullptr;
+    qint64 _mappedSize = 0;
+    SessionReader _reader;
+};
+
+#endif // SAMPLEHISTORY_H
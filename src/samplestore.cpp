@@ -0,0 +1,62 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "samplestore.h"
+#include "channelschema.h"
+
+SampleStore::SampleStore()
+{
+    setChannelCount(ChannelSchema().count());
+}
+
+void SampleStore::setChannelCount(int count)
+{
+    clear();
+    _values.resize(count);
+}
+
+void SampleStore::clear()
+{
+    _time.clear();
+    for (auto &values: _values)
+        values.clear();
+}
+
+void SampleStore::reserve(int size)
+{
+    _time.reserve(size);
+    for (auto &values: _values)
+        values.reserve(size);
+}
+
+void SampleStore::append(const Sample &sample)
+{
+    _time.append(sample.ms);
+    for (int i=0; i<_values.size(); ++i)
+        _values[i].append(sample.values[i]);
+}
+
+void SampleStore::removeFirst(int count)
+{
+    count = qMin(count, _time.size());
+    _time.remove(0, count);
+    for (auto &values: _values)
+        values.remove(0, count);
+}
@@ -0,0 +1,79 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SAMPLESTORE_H
+#define SAMPLESTORE_H
+
+#include "channelview.h"
+#include "sample.h"
+
+#include <QVector>
+
+/**
+ * @brief The samples of a session as structure of arrays.
+ *
+ * The time is stored once for all channels, the values as float, so a
+ * sample of n channels takes 8 + 4n bytes. Every channel is read through a
+ * ChannelView; its columns are contiguous, which is what the vectorized
+ * kernels want.
+ */
+class SampleStore final
+{
+public:
+    SampleStore();
+
+    int channelCount() const {
+        return _values.size();
+    }
+
+    /**
+     * @brief Clears the store and sets the number of channels stored of
+     *        every appended sample.
+     */
+    void setChannelCount(int count);
+
+    void clear();
+    void reserve(int size);
+
+    int size() const {
+        return _time.size();
+    }
+
+    bool isEmpty() const {
+        return _time.isEmpty();
+    }
+
+    void append(const Sample &sample);
+
+    /**
+     * @brief Drops the oldest count samples.
+     */
+    void removeFirst(int count);
+
+    ChannelView channel(int channel) const {
+        return ChannelView(_time.constData(), _values[channel].constData(), _time.size());
+    }
+
+private:
+    QVector<qreal> _time;
+    QVector<QVector<float>> _values;
+};
+
+#endif // SAMPLESTORE_H
@@ -19,138 +19,693 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "serialreader.h"
-#include "douglaspeucker.h"
+#include "csvparser.h"
+#include "minmaxdecimator.h"
+#include "rasterplotitem.h"
+#include "serialworker.h"
 
-#include <QSerialPort>
+#include <QChart>
 #include <QLineSeries>
 #include <QValueAxis>
 #include <QXYSeries>
+#include <QtConcurrent>
+
+#include <functional>
+#include <limits>
+
+namespace {
+
+// Runs the jobs on the global thread pool, the last one on the calling
+// thread, and waits for all of them.
+void runConcurrently(const QVector<std::function<void()>> &jobs)
+{
+    QVector<QFuture<void>> futures;
+    for (int i=0; i<jobs.size()-1; ++i)
+        futures.append(QtConcurrent::run(jobs[i]));
+    if (!jobs.isEmpty())
+        jobs.last()();
+    for (auto &future: futures)
+        future.waitForFinished();
+}
+
+} // namespace
 
 SerialReader::SerialReader(QObject *parent)
     : QObject(parent)
-    , _serialPort(new QSerialPort(this))
-    , _airSeries1(new QLineSeries(this))
-    , _airSeries2(new QLineSeries(this))
-    , _airSeries3(new QLineSeries(this))
-    , _pulseSeries(new QLineSeries(this))
+    , _worker(new SerialWorker)
 {
-    _airSeries1->setName("air1");
-    _airSeries2->setName("air2");
-    _airSeries3->setName("air3");
-    _pulseSeries->setName("pulse");
+    setSchema(_schema);
+    _arrivals.reserve(MaxRenderedArrivals);
+    _rendered.reserve(MaxRenderedArrivals);
+    connect(&_scheduler, &RenderScheduler::render, this, &SerialReader::render);
 
-    _airBuffer1.reserve(_samples);
-    _airBuffer2.reserve(_samples);
-    _airBuffer3.reserve(_samples);
-    _pulseBuffer.reserve(_samples);
+    _worker->setStats(&_stats);
+    _worker->moveToThread(&_thread);
+    connect(&_thread, &QThread::finished, _worker, &QObject::deleteLater);
+    connect(_worker, &SerialWorker::arduinoStarted, this, &SerialReader::arduinoStarted);
+    _thread.setObjectName("SerialWorker");
+    _thread.start(QThread::TimeCriticalPriority);
 }
 
 SerialReader::~SerialReader()
 {
-    if (_serialPort->isOpen())
-        _serialPort->close();
-    delete _serialPort;
+    close();
+    _thread.quit();
+    _thread.wait();
 }
 
-void SerialReader::clear()
+bool SerialReader::isOpen() const
+{
+    return _worker->isOpen();
+}
+
+bool SerialReader::open(const QString &portName, qint32 baudRate)
 {
-    _arduinoReady = false;
-    _airBuffer1.clear();
-    _airBuffer2.clear();
-    _airBuffer3.clear();
-    _pulseBuffer.clear();
+    // Samples of a previous session may still be queued.
+    Sample sample;
+    while (_worker->samples().pop(sample));
+    QByteArray data;
+    while (_worker->rawData().pop(data));
+    LatencyHistogram::Arrival arrival;
+    while (_worker->arrivals().pop(arrival));
+    _arrivals.resize(0);
+    _rendered.resize(0);
+    _latency.clear();
+
+    // The device may still announce other channels.
+    _schemaPending = true;
+    bool opened = false;
+    QMetaObject::invokeMethod(_worker, [&] {
+        opened = _worker->open(portName, baudRate);
+    }, Qt::BlockingQueuedConnection);
+    return opened;
 }
 
-void SerialReader::showPulse(bool show)
+void SerialReader::close()
 {
-    _showPulse = show;
+    if (!isOpen())
+        return;
+    QMetaObject::invokeMethod(_worker, [this] {
+        _worker->close();
+    }, Qt::BlockingQueuedConnection);
 }
 
-void SerialReader::load(const QList<QByteArray> &lines)
+QString SerialReader::errorString() const
+{
+    return _worker->errorString();
+}
+
+quint64 SerialReader::droppedSamples() const
+{
+    return _worker->droppedSamples();
+}
+
+quint64 SerialReader::droppedChunks() const
+{
+    return _worker->droppedChunks();
+}
+
+quint64 SerialReader::invalidLines() const
+{
+    return _worker->invalidLines();
+}
+
+void SerialReader::clear()
+{
+    _store.clear();
+    for (auto &channel: _channels) {
+        channel.simplifier.clear();
+        channel.significance.clear();
+        channel.pyramid.clear();
+    }
+    _history.clear();
+    _session = nullptr;
+    _dropped = 0;
+    _unrendered = 0;
+    _showingHistory = false;
+}
+
+void SerialReader::setSchema(const ChannelSchema &schema)
 {
     clear();
-    process(lines);
+    if (schema == _schema && !_channels.isEmpty())
+        return;
+    _schema = schema;
+
+    for (int i=schema.count(); i<_channels.size(); ++i) {
+        auto series = _channels[i].series;
+        if (series->chart())
+            series->chart()->removeSeries(series);
+        delete series;
+    }
+    _channels.resize(schema.count());
+    for (int i=0; i<_channels.size(); ++i) {
+        auto &channel = _channels[i];
+        if (!channel.series)
+            channel.series = new QLineSeries(this);
+        channel.series->clear();
+        channel.synced = false;
+        channel.series->setName(schema.name(i));
+        channel.simplifier.setEpsilon(_dgEpsilon);
+    }
+    if (_plotItem)
+        _plotItem->setSeries(seriesList());
+    _store.setChannelCount(schema.count());
+    _store.reserve(_samples);
+    emit schemaChanged();
+}
+
+void SerialReader::setChannelVisible(int channel, bool visible)
+{
+    auto &state = _channels[channel];
+    if (state.visible == visible)
+        return;
+    state.visible = visible;
+
+    // A channel shown again catches up with the samples it skipped.
+    auto buffer = this->channel(channel);
+    state.significance.rebuild(buffer);
+    state.pyramid.clear();
+    state.pyramid.update(buffer);
+    restart(state, buffer);
+}
+
+void SerialReader::setPlotItem(RasterPlotItem *item)
+{
+    if (_plotItem == item)
+        return;
+    if (_plotItem)
+        _plotItem->hide();
+    _plotItem = item;
+
+    // Whichever drew the channels so far is emptied.
+    for (auto &channel: _channels) {
+        channel.series->clear();
+        channel.synced = false;
+    }
+    if (_plotItem) {
+        _plotItem->setSeries(seriesList());
+        _plotItem->show();
+    }
+    if (_axisX)
+        reload();
+}
+
+bool SerialReader::setHistoryFile(const QString &fileName)
+{
+    if (!_history.open(fileName, _schema))
+        return false;
+
+    // The budget bounds the live buffers now; they are allocated at once
+    // instead of growing during the session. Pages not used yet are not
+    // committed by the OS.
+    reserve(static_cast<int>(qMin(liveCapacity() + SessionFile::ChunkSize,
+                                  qint64(std::numeric_limits<int>::max()))));
+    return true;
+}
+
+void SerialReader::setSession(const SessionReader *session)
+{
+    setSchema(session->schema());
+    _session = session;
+
+    // The chunks of the last visible range become the live buffers; the
+    // ones before them count as dropped to the history.
+    auto &chunks = session->chunks();
+    if (chunks.isEmpty())
+        return;
+    auto first = session->findChunk(chunks.last().max.ms - _samples);
+    _paged.clear();
+    for (int i=first; i<chunks.size(); ++i)
+        session->read(i, _paged);
+    for (auto &sample: _paged)
+        append(sample);
+    _dropped = session->sampleCount() - _store.size();
+
+    forEachChannel([](Channel &channel, const ChannelView &buffer) {
+        channel.significance.rebuild(buffer);
+        channel.pyramid.update(buffer);
+    });
+    reload();
+}
+
+void SerialReader::setAxisX(QValueAxis *axisX)
+{
+    if (_axisX)
+        disconnect(_axisX, nullptr, this, nullptr);
+    _axisX = axisX;
+    connect(_axisX, &QValueAxis::rangeChanged, this, &SerialReader::updateView);
+}
+
+void SerialReader::setPlotWidth(int width)
+{
+    if (_plotWidth == width)
+        return;
+    _plotWidth = width;
+    updateView();
+}
+
+void SerialReader::setDpEpsilon(qreal epsilon)
+{
+    _dgEpsilon = epsilon;
+
+    // Keep a running acquisition from simplifying its whole history again.
+    for (int i=0; i<_channels.size(); ++i) {
+        _channels[i].simplifier.setEpsilon(epsilon);
+        restart(_channels[i], channel(i));
+    }
+}
+
+void SerialReader::load(const QByteArray &data)
+{
+    // Data without a header is taken for the default schema.
+    auto newline = data.indexOf('\n');
+    auto headerEnd = data.constData() + (newline < 0 ? data.size() : newline);
+    ChannelSchema schema;
+    ChannelSchema::fromHeader(data.constData(), headerEnd, schema);
+    setSchema(schema);
+    process(data);
+}
+
+void SerialReader::loadSamples(const QVector<Sample> &samples)
+{
+    for (auto &sample: samples)
+        append(sample);
+
+    forEachChannel([](Channel &channel, const ChannelView &buffer) {
+        channel.significance.update(buffer);
+        channel.pyramid.update(buffer);
+    });
+
+    reload();
+}
+
+void SerialReader::finishLoad()
+{
+    forEachChannel([](Channel &channel, const ChannelView &buffer) {
+        channel.significance.rebuild(buffer);
+    });
+
+    reload();
 }
 
 void SerialReader::reload()
 {
-    process({});
+    if (_decimation == Decimation::MinMax) {
+        showLatest();
+        return;
+    }
+
+    for (int i=0; i<_channels.size(); ++i) {
+        auto buffer = channel(i);
+        QVector<QPointF> dpr;
+        _channels[i].significance.filter(buffer, buffer.size()-1, _dgEpsilon, dpr);
+        replace(i, dpr);
+    }
+
+    if (!_store.isEmpty())
+        showUntil(_store.channel(0).last().x());
 }
 
 void SerialReader::read()
 {
-    _buffer.append(_serialPort->readAll());
-    int index = _buffer.lastIndexOf('\n') + 1;
-    auto data = _buffer.left(index);
-    _buffer.remove(0, index);
-
-    QList<QByteArray> lines;
-    for (auto line: data.split('\n')) {
-        if (line.isEmpty())
-            continue;
-        if (_arduinoReady) {
-            lines.push_back(line);
-        } else {
-            _arduinoReady = line.contains("Arduino Ready");
-            if (_arduinoReady)
-                emit arduinoStarted();
+    // Parsing happens on the acquisition thread; only drain its queues.
+    PipelineStats::Tick ingest(&_stats, PipelineStats::Ingest);
+
+    // An arrival is pushed after its samples, so they are all drained
+    // below; samples of an arrival still to come wait at most a tick.
+    LatencyHistogram::Arrival arrival;
+    while (_worker->arrivals().pop(arrival))
+        addArrival(_arrivals, arrival);
+
+    Sample sample;
+    int count = 0;
+    while (_worker->samples().pop(sample)) {
+        if (_schemaPending) {
+            // The header of the device, if any, came before this sample.
+            _schemaPending = false;
+            if (_worker->schema() != _schema) {
+                auto historyFile = _history.isOpen() ? _history.fileName() : QString();
+                setSchema(_worker->schema());
+                if (!historyFile.isEmpty())
+                    setHistoryFile(historyFile);
+            }
+        }
+        append(sample);
+        _history.append(sample);
+        ++count;
+    }
+    if (!isOpen())
+        _history.close();
+    trim();
+
+    // The indices keep up with every sample; drawing them is left to the
+    // next frame.
+    if (count > 0) {
+        forEachChannel([](Channel &channel, const ChannelView &buffer) {
+            channel.significance.update(buffer);
+            channel.pyramid.update(buffer);
+        }, count >= MinConcurrentSamples);
+        _unrendered += count;
+        _scheduler.requestRender();
+        ingest.addPoints(count, 0);
+    } else {
+        // Idle ticks would only hide the cost of the busy ones.
+        ingest.discard();
+    }
+
+    // Every receiver separates consecutive chunks by a newline anyway, so
+    // they are passed on as they are instead of being joined.
+    QByteArray data;
+    while (_worker->rawData().pop(data))
+        emit newData(data);
+}
+
+void SerialReader::render()
+{
+    if (_decimation == Decimation::MinMax) {
+        showLatest();
+        markRendered();
+        return;
+    }
+
+    // Only the samples after the last stable vertex are simplified again.
+    PipelineStats::Tick simplify(&_stats, PipelineStats::Simplify);
+    forEachChannel([](Channel &channel, const ChannelView &buffer) {
+        channel.simplifier.update(buffer);
+    }, _unrendered >= MinConcurrentSamples);
+    simplify.stop();
+
+    PipelineStats::Tick update(&_stats, PipelineStats::Update);
+    qint64 added = 0;
+    qint64 vertices = 0;
+    for (int i=0; i<_channels.size(); ++i) {
+        added += updateSeries(i);
+        vertices += _channels[i].simplifier.result().size();
+    }
+    simplify.addPoints(_unrendered, added);
+    update.addPoints(added, vertices);
+    _unrendered = 0;
+
+    if (!_store.isEmpty())
+        showUntil(_store.channel(0).last().x());
+    markRendered();
+}
+
+void SerialReader::updateView()
+{
+    if (!_axisX)
+        return;
+
+    auto minX = _axisX->min();
+    auto maxX = _axisX->max();
+    if (_dropped > 0 && !_store.isEmpty() &&
+            minX < _store.channel(0).first().x()) {
+        showHistory(minX, maxX);
+        return;
+    }
+    if (_showingHistory) {
+        // Back in memory; show the live buffers again.
+        _showingHistory = false;
+        if (_decimation != Decimation::MinMax) {
+            reload();
+            return;
         }
     }
+    if (_decimation != Decimation::MinMax)
+        return;
 
-    for (auto line: lines) {
-        appendValues(line.split(','));
+    PipelineStats::Tick decimate(&_stats, PipelineStats::Simplify, false);
+    PipelineStats::Tick update(&_stats, PipelineStats::Update, false);
+    for (int i=0; i<_channels.size(); ++i) {
+        auto buffer = channel(i);
+        decimate.start();
+        _channels[i].pyramid.query(buffer, minX, maxX, _plotWidth, _decimated);
+        decimate.stop();
+        update.start();
+        replace(i, _decimated);
+        update.stop();
+        if (_stats.isEnabled()) {
+            auto visible = buffer.lowerBound(maxX) - buffer.lowerBound(minX);
+            decimate.addPoints(visible, _decimated.size());
+            update.addPoints(_decimated.size(), _decimated.size());
+        }
     }
+    _unrendered = 0;
+}
 
-    QVector<QPointF> dprAir1;
-    DouglasPeucker::douglasPeucker(_airBuffer1, _dgEpsilon, dprAir1);
-    _airSeries1->replace(dprAir1);
-    QVector<QPointF> dprAir2;
-    DouglasPeucker::douglasPeucker(_airBuffer2, _dgEpsilon, dprAir2);
-    _airSeries2->replace(dprAir2);
-    QVector<QPointF> dprAir3;
-    DouglasPeucker::douglasPeucker(_airBuffer3, _dgEpsilon, dprAir3);
-    _airSeries3->replace(dprAir3);
-    QVector<QPointF> dprPulse;
-    DouglasPeucker::douglasPeucker(_pulseBuffer, _dgEpsilon, dprPulse);
-    _pulseSeries->replace(dprPulse);
+void SerialReader::chartPainted(qreal cost)
+{
+    _scheduler.framePainted(cost);
+    if (_rendered.isEmpty())
+        return;
+    auto now = LatencyHistogram::now();
+    for (auto &arrival: _rendered)
+        _latency.add(now - arrival.nsecs, arrival.samples);
+    _rendered.resize(0);
+}
+
+void SerialReader::append(const Sample &sample)
+{
+    _store.append(sample);
+}
+
+void SerialReader::process(const QByteArray &data)
+{
+    // The header and any other invalid line are skipped by the parser.
+    Sample sample;
+    auto channels = _schema.count();
+    auto parse = [&](const char *lineBegin, const char *lineEnd) {
+        if (CsvParser::parse(lineBegin, lineEnd, channels, sample))
+            append(sample);
+    };
+    auto end = data.constData() + data.size();
+    auto rest = CsvParser::forEachLine(data.constData(), end, parse);
+    if (rest != end)
+        parse(rest, end);
 
-    if (!dprAir1.isEmpty())
-        _axisX->setMax(dprAir1.last().x());
+    forEachChannel([](Channel &channel, const ChannelView &buffer) {
+        channel.significance.rebuild(buffer);
+        channel.pyramid.update(buffer);
+    });
 
-    if (!lines.isEmpty())
-        emit newData(lines.join("\n"));
+    reload();
 }
 
-void SerialReader::appendValues(const QList<QByteArray> &columns)
+ChannelView SerialReader::channel(int channel) const
 {
-    if (columns.size() != 6)
+    // A hidden channel is not simplified or decimated at all.
+    if (!_channels[channel].visible)
+        return ChannelView();
+    return _store.channel(channel);
+}
+
+void SerialReader::forEachChannel(const ChannelFunction &function, bool concurrent)
+{
+    if (!concurrent) {
+        for (int i=0; i<_channels.size(); ++i)
+            function(_channels[i], channel(i));
         return;
-    auto ms = columns[0].toDouble();
-    _airBuffer1.append(QPointF(ms, columns[2].toInt()));
-    _airBuffer2.append(QPointF(ms, columns[3].toInt()));
-    _airBuffer3.append(QPointF(ms, columns[4].toInt()));
-    if (_showPulse && columns.size() == 6)
-        _pulseBuffer.append(QPointF(ms, columns[5].toInt()));
+    }
+
+    // The channels are independent of each other, so adding channels adds
+    // jobs rather than time.
+    QVector<std::function<void()>> jobs;
+    jobs.reserve(_channels.size());
+    for (int i=0; i<_channels.size(); ++i) {
+        auto channel = &_channels[i];
+        auto buffer = this->channel(i);
+        jobs.append([&function, channel, buffer] { function(*channel, buffer); });
+    }
+    runConcurrently(jobs);
 }
 
-void SerialReader::process(const QList<QByteArray> &lines)
+void SerialReader::showUntil(qreal maxX)
 {
-    for (auto line: lines)
-        appendValues(line.split(','));
+    // Following keeps the width of the view and scrolls it instead.
+    if (_following)
+        _axisX->setRange(maxX - (_axisX->max() - _axisX->min()), maxX);
+    else
+        _axisX->setMax(maxX);
+}
 
-    QVector<QPointF> dprAir1;
-    DouglasPeucker::douglasPeucker(_airBuffer1, _dgEpsilon, dprAir1);
-    _airSeries1->replace(dprAir1);
-    QVector<QPointF> dprAir2;
-    DouglasPeucker::douglasPeucker(_airBuffer2, _dgEpsilon, dprAir2);
-    _airSeries2->replace(dprAir2);
-    QVector<QPointF> dprAir3;
-    DouglasPeucker::douglasPeucker(_airBuffer3, _dgEpsilon, dprAir3);
-    _airSeries3->replace(dprAir3);
-    QVector<QPointF> dprPulse;
-    DouglasPeucker::douglasPeucker(_pulseBuffer, _dgEpsilon, dprPulse);
-    _pulseSeries->replace(dprPulse);
+void SerialReader::showLatest()
+{
+    // Moving the axis decimates again through updateView().
+    auto time = _store.channel(0);
+    if (!time.isEmpty() && time.last().x() != _axisX->max())
+        showUntil(time.last().x());
+    else
+        updateView();
+}
 
-    if (!dprAir1.isEmpty())
-        _axisX->setMax(dprAir1.last().x());
+void SerialReader::markRendered()
+{
+    // They are on screen with the next paint of the chart.
+    for (auto &arrival: _arrivals)
+        addArrival(_rendered, arrival);
+    _arrivals.resize(0);
+}
+
+void SerialReader::addArrival(QVector<LatencyHistogram::Arrival> &arrivals,
+                              const LatencyHistogram::Arrival &arrival)
+{
+    // Beyond the reserved size, the samples are added to the last arrival
+    // kept. It is older, so they count with a longer latency rather than
+    // not at all, and the percentiles are not too low under load.
+    if (arrivals.size() < MaxRenderedArrivals)
+        arrivals.append(arrival);
+    else
+        arrivals.last().samples += arrival.samples;
+}
+
+qint64 SerialReader::liveCapacity() const
+{
+    return qMax(_memoryBudget / bytesPerSample(), qint64(2 * SessionFile::ChunkSize));
+}
+
+void SerialReader::reserve(int size)
+{
+    _store.reserve(size);
+    for (auto &channel: _channels) {
+        channel.significance.reserve(size);
+        channel.pyramid.reserve(size);
+    }
+}
+
+void SerialReader::trim()
+{
+    if (!_history.isOpen() || _store.isEmpty())
+        return;
+    auto capacity = liveCapacity();
+    if (_store.size() <= capacity)
+        return;
+
+    // The older half is dropped at once, so the indices are adjusted only
+    // every capacity/2 samples. The visible range and the samples not yet
+    // written to the history stay; store index i is history sample
+    // _dropped + i.
+    auto time = _store.channel(0);
+    auto visible = time.lowerBound(time.last().x() - _samples);
+    auto count = qMin(qint64(_store.size()) - capacity / 2, qint64(visible));
+    count = qMin(count, _history.written() - _dropped);
+    if (count < capacity / 4)
+        return;
+
+    _store.removeFirst(static_cast<int>(count));
+    _dropped += count;
+
+    // Only the first significance block is recomputed, the rest is a
+    // linear pass, so the channels are not worth the jobs, which allocate.
+    forEachChannel([this, count](Channel &channel, const ChannelView &buffer) {
+        channel.significance.removeFirst(buffer, static_cast<int>(count));
+        channel.pyramid.clear();
+        channel.pyramid.update(buffer);
+        restart(channel, buffer);
+    }, false);
+}
+
+const SessionReader& SerialReader::historyReader()
+{
+    return _session ? *_session : _history.reader();
+}
+
+void SerialReader::showHistory(qreal minX, qreal maxX)
+{
+    _showingHistory = true;
+    auto &reader = historyReader();
+    auto &chunks = reader.chunks();
+
+    // Everything before the live buffers is paged in from the history.
+    auto split = qMin(maxX, _store.channel(0).first().x());
+    auto first = reader.findChunk(minX);
+    auto last = first;
+    while (last < chunks.size() && chunks[last].min.ms < split)
+        ++last;
+
+    // Zoomed out that far, a chunk covers hardly more than a pixel; the
+    // minimum and maximum from its header are drawn instead of its samples.
+    _paged.clear();
+    if (last - first > MaxPagedChunks) {
+        for (int i=first; i<last; ++i) {
+            _paged.append(chunks[i].min);
+            _paged.append(chunks[i].max);
+        }
+    } else {
+        for (int i=first; i<last; ++i)
+            reader.read(i, _paged);
+    }
+
+    auto historyWidth = qRound(_plotWidth * (split - minX) / (maxX - minX));
+    for (int i=0; i<_channels.size(); ++i) {
+        if (_channels[i].visible)
+            showHistory(i, minX, split, maxX, historyWidth);
+    }
+}
+
+void SerialReader::showHistory(int channel, qreal minX, qreal split, qreal maxX,
+                               int historyWidth)
+{
+    _pagedChannel.clear();
+    for (auto &sample: _paged) {
+        if (sample.ms >= split)
+            break;
+        _pagedChannel.append(sample.ms, sample.values[channel]);
+    }
+    MinMaxDecimator::decimate(_pagedChannel, minX, split, historyWidth, _decimated);
+
+    if (maxX > split) {
+        _channels[channel].pyramid.query(this->channel(channel), split, maxX,
+                                         _plotWidth - historyWidth, _livePoints);
+        _decimated.append(_livePoints);
+    }
+    replace(channel, _decimated);
+}
+
+int SerialReader::updateSeries(int index)
+{
+    // Only the vertices after the unchanged prefix are removed and added
+    // again, so the chart does not rebuild the whole polyline every tick.
+    auto &channel = _channels[index];
+    auto &result = channel.simplifier.result();
+    auto unchanged = channel.synced ? channel.simplifier.unchanged() : 0;
+    auto added = result.size() - unchanged;
+    if (_plotItem) {
+        _plotItem->setPoints(index, result, unchanged);
+    } else if (unchanged == 0 || added > MaxAppendedPoints) {
+        channel.series->replace(result);
+    } else {
+        auto removed = channel.series->count() - unchanged;
+        if (removed > 0)
+            channel.series->removePoints(unchanged, removed);
+        for (int i=unchanged; i<result.size(); ++i)
+            channel.series->append(result[i]);
+    }
+    channel.simplifier.markUnchanged();
+    channel.synced = true;
+    return added;
+}
+
+void SerialReader::replace(int channel, const QVector<QPointF> &points)
+{
+    if (_plotItem)
+        _plotItem->setPoints(channel, points);
+    else
+        _channels[channel].series->replace(points);
+    _channels[channel].synced = false;
+}
+
+QVector<QXYSeries*> SerialReader::seriesList() const
+{
+    QVector<QXYSeries*> series;
+    for (auto &channel: _channels)
+        series.append(channel.series);
+    return series;
+}
+
+void SerialReader::restart(Channel &channel, const ChannelView &buffer)
+{
+    auto &prefix = channel.prefix;
+    channel.significance.filter(buffer, channel.significance.sealed(), _dgEpsilon, prefix);
+    channel.simplifier.restart(prefix, channel.significance.sealed());
 }
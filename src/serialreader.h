@@ -21,11 +21,26 @@
 #ifndef SERIALREADER_H
 #define SERIALREADER_H
 
+#include "channelschema.h"
+#include "latencyhistogram.h"
+#include "lodpyramid.h"
+#include "pipelinestats.h"
+#include "renderscheduler.h"
+#include "sample.h"
+#include "samplehistory.h"
+#include "samplestore.h"
+#include "significanceindex.h"
+#include "streamingsimplifier.h"
+
 #include <QObject>
 #include <QChartGlobal>
 #include <QPointF>
+#include <QSerialPortInfo>
+#include <QThread>
 #include <QVector>
 
+#include <functional>
+
 QT_CHARTS_BEGIN_NAMESPACE
 class QLineSeries;
 class QValueAxis;
@@ -34,50 +49,140 @@ QT_CHARTS_END_NAMESPACE
 
 QT_CHARTS_USE_NAMESPACE
 
-class QSerialPort;
+class RasterPlotItem;
+class SerialWorker;
 
 class SerialReader : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief How the sample buffers are reduced before they are rendered.
+     */
+    enum class Decimation {
+        DouglasPeucker,
+        MinMax
+    };
+
     SerialReader(QObject *parent = nullptr);
     ~SerialReader();
 
     void clear();
 
-    void setAxisX(QValueAxis *axisX) {
-        _axisX = axisX;
-    }
+    void setAxisX(QValueAxis *axisX);
 
     qreal dpEpsilon() const {
         return _dgEpsilon;
     }
 
-    void setDpEpsilon(qreal epsilon) {
-        _dgEpsilon = epsilon;
+    void setDpEpsilon(qreal epsilon);
+
+    bool isOpen() const;
+    bool open(const QString &portName, qint32 baudRate);
+
+    bool open(const QSerialPortInfo &portInfo, qint32 baudRate) {
+        return open(portInfo.systemLocation(), baudRate);
+    }
+    void close();
+
+    /**
+     * @brief The error of the last failed open().
+     */
+    QString errorString() const;
+
+    /**
+     * @brief Samples received in this session, including the ones paged
+     *        out to the history.
+     */
+    qint64 sampleCount() const {
+        return _dropped + _store.size();
+    }
+
+    /**
+     * @brief Samples kept in memory; the older ones are only in the
+     *        history.
+     */
+    int liveSampleCount() const {
+        return _store.size();
+    }
+
+    /**
+     * @brief Samples lost because read() was not called often enough.
+     */
+    quint64 droppedSamples() const;
+
+    /**
+     * @brief Raw chunks lost for newData() because read() was not called
+     *        often enough.
+     */
+    quint64 droppedChunks() const;
+
+    /**
+     * @brief Lines of this session that were no valid sample.
+     */
+    quint64 invalidLines() const;
+
+    const ChannelSchema& schema() const {
+        return _schema;
+    }
+
+    /**
+     * @brief Clears the samples and creates a series per channel of schema.
+     *
+     * The series of the channels still present are kept; the others are
+     * removed from their chart and deleted. A live session adopts the
+     * schema of the device on its own.
+     */
+    void setSchema(const ChannelSchema &schema);
+
+    int channelCount() const {
+        return _channels.size();
     }
 
-    QSerialPort* serialPort() const {
-        return _serialPort;
+    QXYSeries* series(int channel) const {
+        return _channels[channel].series;
     }
 
-    QXYSeries* airSeries1() const {
-        return _airSeries1;
+    bool isChannelVisible(int channel) const {
+        return _channels[channel].visible;
     }
 
-    QXYSeries* airSeries2() const {
-        return _airSeries2;
+    /**
+     * @brief Hidden channels are stored, but neither simplified nor drawn.
+     */
+    void setChannelVisible(int channel, bool visible);
+
+    RasterPlotItem* plotItem() const {
+        return _plotItem;
     }
 
-    QXYSeries* airSeries3() const {
-        return _airSeries3;
+    /**
+     * @brief Draws the channels with item instead of their series, or
+     *        with the series again if item is nullptr.
+     *
+     * The series stay in the chart for the legend, but empty.
+     */
+    void setPlotItem(RasterPlotItem *item);
+
+    bool isFollowing() const {
+        return _following;
     }
 
-    QXYSeries* pulseSeries() const {
-        return _pulseSeries;
+    /**
+     * @brief Scrolls the view along with new samples instead of stretching
+     *        it.
+     */
+    void setFollowing(bool following) {
+        _following = following;
     }
 
+    /**
+     * @brief Width of the visible x range in ms.
+     *
+     * The samples of this range are always kept in memory, even if they
+     * exceed the memory budget.
+     */
     int samples() const {
         return _samples;
     }
@@ -86,42 +191,252 @@ public:
         _samples = samples;
     }
 
-    void showPulse(bool show);
+    qint64 memoryBudget() const {
+        return _memoryBudget;
+    }
+
+    /**
+     * @brief Limits the memory of the live sample buffers in bytes.
+     *
+     * Once exceeded, the older half is dropped from memory; it is paged in
+     * from the history file when it is scrolled into view again. The
+     * buffers are allocated for the budget by setHistoryFile().
+     */
+    void setMemoryBudget(qint64 bytes) {
+        _memoryBudget = bytes;
+    }
+
+    /**
+     * @brief Starts writing every received sample to fileName, a session
+     *        file, so old samples can be dropped from memory.
+     *
+     * Without history the buffers grow without limit. With it, they are
+     * allocated for the memory budget right away, so that storing samples
+     * does not allocate anymore. The history ends once the port is closed
+     * and the remaining samples are read; it stays readable until clear().
+     */
+    bool setHistoryFile(const QString &fileName);
+
+    /**
+     * @brief Shows session, an opened session file, without loading it.
+     *
+     * Only the chunks of the last samples() ms are kept in memory; the
+     * rest is paged in from session like the history of a live session.
+     * session must stay open until clear() or setSchema().
+     */
+    void setSession(const SessionReader *session);
+
+    /**
+     * @brief The history file of the session, until clear().
+     */
+    QString historyFileName() const {
+        return _history.fileName();
+    }
+
+    QString historyErrorString() const {
+        return _history.errorString();
+    }
+
+    Decimation decimation() const {
+        return _decimation;
+    }
+
+    void setDecimation(Decimation decimation) {
+        _decimation = decimation;
+    }
+
+    int plotWidth() const {
+        return _plotWidth;
+    }
+
+    void setPlotWidth(int width);
+
+    int frameRate() const {
+        return _scheduler.frameRate();
+    }
+
+    /**
+     * @brief Limits how often the chart is updated while data arrives.
+     *
+     * Received samples are stored right away; they are drawn with the next
+     * frame. The actual rate drops below frameRate if drawing takes too
+     * long.
+     */
+    void setFrameRate(int frameRate) {
+        _scheduler.setFrameRate(frameRate);
+    }
+
+    /**
+     * @brief Durations of the acquisition and drawing stages; disabled
+     *        unless someone shows them.
+     */
+    PipelineStats& stats() {
+        return _stats;
+    }
+
+    /**
+     * @brief Delay of the samples of the current session from their arrival
+     *        to the first paint of the chart after they were rendered.
+     */
+    const LatencyHistogram& latency() const {
+        return _latency;
+    }
 
-    void load(const QList<QByteArray> &lines);
+    void load(const QByteArray &data);
     void reload();
 
+    /**
+     * @brief Appends the next chunk of a file that is still being loaded
+     *        and shows what has been loaded so far.
+     */
+    void loadSamples(const QVector<Sample> &samples);
+
+    /**
+     * @brief Replaces the block-wise significance of loadSamples() with the
+     *        one of the whole file.
+     */
+    void finishLoad();
+
 signals:
     void newData(const QByteArray &data);
     void arduinoStarted();
 
+    /**
+     * @brief The channels and with them the series changed.
+     */
+    void schemaChanged();
+
 public slots:
     void read();
+    void updateView();
+
+    /**
+     * @brief Counts the samples rendered since the last paint as shown and
+     *        lets the frame rate follow the cost of the paint in ms.
+     */
+    void chartPainted(qreal cost);
+
+private slots:
+    void render();
 
 private:
-    void appendValues(const QList<QByteArray> &columns);
-    void process(const QList<QByteArray> &lines);
+    /**
+     * @brief Everything kept per channel besides its samples.
+     */
+    struct Channel {
+        QXYSeries *series = nullptr;
+        bool visible = true;
+
+        /**
+         * @brief Whether series shows the simplifier's result as of its
+         *        last markUnchanged().
+         */
+        bool synced = false;
+        SignificanceIndex significance;
+        StreamingSimplifier simplifier;
+        LodPyramid pyramid;
+
+        /**
+         * @brief Scratch space of restart(), kept so that trim() does not
+         *        allocate.
+         */
+        QVector<QPointF> prefix;
+    };
+
+    using ChannelFunction = std::function<void(Channel &channel, const ChannelView &buffer)>;
+
+    void append(const Sample &sample);
+    void process(const QByteArray &data);
+    ChannelView channel(int channel) const;
+    void forEachChannel(const ChannelFunction &function, bool concurrent = true);
+    void showUntil(qreal maxX);
+    void showLatest();
+    int updateSeries(int channel);
+    void replace(int channel, const QVector<QPointF> &points);
+    QVector<QXYSeries*> seriesList() const;
+    void restart(Channel &channel, const ChannelView &buffer);
+    void markRendered();
+    static void addArrival(QVector<LatencyHistogram::Arrival> &arrivals,
+                           const LatencyHistogram::Arrival &arrival);
+    qint64 liveCapacity() const;
+    void reserve(int size);
+    void trim();
+    const SessionReader& historyReader();
+    void showHistory(qreal minX, qreal maxX);
+    void showHistory(int channel, qreal minX, qreal split, qreal maxX, int historyWidth);
 
 private:
-    bool _arduinoReady = false;
-    bool _showPulse = false;
+    /**
+     * @brief Memory per sample: its time and, per channel, the value, its
+     *        significance and its share of the pyramid.
+     */
+    qint64 bytesPerSample() const {
+        return sizeof(qreal) + _channels.size()
+                * (sizeof(float) + sizeof(qreal) + sizeof(int));
+    }
+
+    /**
+     * @brief Above this number of chunks, the history is drawn from the
+     *        chunk headers instead of the samples.
+     */
+    static const int MaxPagedChunks = 256;
+
+    /**
+     * @brief Above this number of new vertices, a series is replaced as a
+     *        whole.
+     *
+     * The chart updates its geometry for each appended point; for many
+     * points a single replace() is cheaper.
+     */
+    static const int MaxAppendedPoints = 64;
+
+    /**
+     * @brief Below this number of new samples, the channels are processed
+     *        one after the other on the calling thread.
+     *
+     * Dispatching jobs to the pool costs more than a few samples per
+     * channel, and it allocates on every tick.
+     */
+    static const int MinConcurrentSamples = 4096;
+
+    /**
+     * @brief Arrivals kept until they are rendered and painted, e.g. while
+     *        the window is minimized; more are merged by addArrival().
+     */
+    static const int MaxRenderedArrivals = 1 << 12;
+
     int _position = 0;
     int _samples = 1000;
+    int _plotWidth = 0;
+    qint64 _memoryBudget = qint64(256) * 1024 * 1024;
     qreal _dgEpsilon = 2.0;
+    Decimation _decimation = Decimation::DouglasPeucker;
 
-    QSerialPort *_serialPort;
+    QThread _thread;
+    SerialWorker *_worker;
+    RenderScheduler _scheduler;
+    PipelineStats _stats;
+    qint64 _unrendered = 0;
+    LatencyHistogram _latency;
+    QVector<LatencyHistogram::Arrival> _arrivals;
+    QVector<LatencyHistogram::Arrival> _rendered;
 
-    QByteArray _buffer;
+    ChannelSchema _schema;
+    bool _schemaPending = false;
+    QVector<Channel> _channels;
+    SampleStore _store;
+    QVector<QPointF> _decimated;
+    QValueAxis *_axisX = nullptr;
+    RasterPlotItem *_plotItem = nullptr;
+    bool _following = false;
 
-    QXYSeries *_airSeries1;
-    QXYSeries *_airSeries2;
-    QXYSeries *_airSeries3;
-    QXYSeries *_pulseSeries;
-    QVector<QPointF> _airBuffer1;
-    QVector<QPointF> _airBuffer2;
-    QVector<QPointF> _airBuffer3;
-    QVector<QPointF> _pulseBuffer;
-    QValueAxis *_axisX;
+    SampleHistory _history;
+    const SessionReader *_session = nullptr;
+    qint64 _dropped = 0;
+    bool _showingHistory = false;
+    QVector<Sample> _paged;
+    ChannelBuffer _pagedChannel;
+    QVector<QPointF> _livePoints;
 };
 
 #endif // SERIALREADER_H
@@ -0,0 +1,160 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "serialworker.h"
+#include "csvparser.h"
+
+#include <QSerialPort>
+
+#include <algorithm>
+
+namespace {
+
+const char ReadyMessage[] = "Arduino Ready";
+
+} // namespace
+
+SerialWorker::SerialWorker(QObject *parent)
+    : QObject(parent)
+    , _serialPort(new QSerialPort(this))
+    , _samples(SampleCapacity)
+    , _rawData(RawDataCapacity)
+    , _arrivals(ArrivalCapacity)
+{
+    _buffer.reserve(BufferCapacity);
+    connect(_serialPort, &QSerialPort::readyRead, this, &SerialWorker::read);
+}
+
+SerialWorker::~SerialWorker()
+{
+    close();
+}
+
+bool SerialWorker::open(const QString &portName, qint32 baudRate)
+{
+    if (_serialPort->isOpen())
+        return true;
+
+    _arduinoReady = false;
+    _headerReceived = false;
+    _schema = ChannelSchema();
+    _buffer.resize(0);
+    _droppedSamples = 0;
+    _droppedChunks = 0;
+    _pendingArrival = LatencyHistogram::Arrival();
+    _invalidLines = 0;
+    _serialPort->setPortName(portName);
+    if (!_serialPort->setBaudRate(baudRate, QSerialPort::AllDirections) ||
+            !_serialPort->open(QIODevice::ReadOnly)) {
+        _errorString = QString("Failed to open port %1 error: %2")
+                .arg(_serialPort->portName())
+                .arg(_serialPort->errorString());
+        return false;
+    }
+
+    // Required on Windows; otherwise the Arduion restart does not happen
+    _serialPort->setRequestToSend(true);
+    _serialPort->setDataTerminalReady(true);
+
+    _errorString.clear();
+    _open = true;
+    return true;
+}
+
+void SerialWorker::close()
+{
+    if (_serialPort->isOpen())
+        _serialPort->close();
+    _open = false;
+}
+
+void SerialWorker::read()
+{
+    PipelineStats::Tick tick(_stats, PipelineStats::Read);
+    LatencyHistogram::Arrival arrival;
+    arrival.nsecs = LatencyHistogram::now();
+
+    // Read straight behind the unterminated rest of the previous call; the
+    // buffer keeps its capacity, so this does not allocate once warmed up.
+    auto rest = _buffer.size();
+    auto available = static_cast<int>(_serialPort->bytesAvailable());
+    _buffer.resize(rest + available);
+    auto received = _serialPort->read(_buffer.data() + rest, available);
+    _buffer.resize(rest + static_cast<int>(qMax<qint64>(received, 0)));
+
+    auto begin = _buffer.constData();
+    auto end = begin + _buffer.size();
+    QByteArray raw;
+    Sample sample;
+    int parsed = 0;
+    auto consumed = CsvParser::forEachLine(begin, end, [&](const char *lineBegin, const char *lineEnd) {
+        if (lineBegin == lineEnd)
+            return;
+        if (!_arduinoReady) {
+            _arduinoReady = std::search(lineBegin, lineEnd, ReadyMessage,
+                                        ReadyMessage + qstrlen(ReadyMessage)) != lineEnd;
+            if (_arduinoReady)
+                emit arduinoStarted();
+            return;
+        }
+
+        // One allocation for all lines of this chunk.
+        auto appendRaw = [&](const char *rawBegin, int size) {
+            if (raw.isEmpty())
+                raw.reserve(static_cast<int>(end - lineBegin) + size);
+            else
+                raw.append('\n');
+            raw.append(rawBegin, size);
+        };
+
+        if (!_headerReceived && ChannelSchema::fromHeader(lineBegin, lineEnd, _schema)) {
+            _headerReceived = true;
+        } else if (CsvParser::parse(lineBegin, lineEnd, _schema.count(), sample)) {
+            if (!_headerReceived) {
+                // The schema is fixed from now on; a device without header
+                // gets the default one in its raw data as well.
+                _headerReceived = true;
+                auto header = _schema.header();
+                appendRaw(header.constData(), header.size());
+            }
+            if (_samples.push(sample))
+                ++arrival.samples;
+            else
+                ++_droppedSamples;
+            ++parsed;
+        } else {
+            ++_invalidLines;
+        }
+        appendRaw(lineBegin, static_cast<int>(lineEnd - lineBegin));
+    });
+    _buffer.remove(0, static_cast<int>(consumed - begin));
+
+    if (!raw.isEmpty() && !_rawData.push(raw))
+        ++_droppedChunks;
+    // While the queue is full, the samples are added to the oldest arrival
+    // still waiting, so they count with its longer latency.
+    if (_pendingArrival.samples > 0)
+        _pendingArrival.samples += arrival.samples;
+    else
+        _pendingArrival = arrival;
+    if (_pendingArrival.samples > 0 && _arrivals.push(_pendingArrival))
+        _pendingArrival.samples = 0;
+    tick.addPoints(qMax<qint64>(received, 0), parsed);
+}
@@ -0,0 +1,172 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include "channelschema.h"
+#include "latencyhistogram.h"
+#include "pipelinestats.h"
+#include "sample.h"
+#include "spscqueue.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+
+class QSerialPort;
+
+/**
+ * @brief Reads and parses the serial data on its own thread.
+ *
+ * The worker lives on the acquisition thread and parses every line as soon
+ * as readyRead() arrives, so a busy GUI thread can neither delay reading
+ * nor cause serial overruns. Parsed samples and the raw lines are handed
+ * over to the GUI through lock-free single-producer/single-consumer queues,
+ * which the GUI drains at its own pace.
+ *
+ * A device may announce its channels by sending a CSV header after it is
+ * ready and before its first sample; otherwise the default schema is
+ * assumed. Either way the raw data starts with the header line.
+ */
+class SerialWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SerialWorker(QObject *parent = nullptr);
+    ~SerialWorker();
+
+    bool isOpen() const {
+        return _open;
+    }
+
+    /**
+     * @brief The error of the last failed open().
+     */
+    QString errorString() const {
+        return _errorString;
+    }
+
+    /**
+     * @brief Number of samples lost because the GUI did not drain the queue.
+     */
+    quint64 droppedSamples() const {
+        return _droppedSamples;
+    }
+
+    /**
+     * @brief Number of raw chunks lost because the GUI did not drain the
+     *        queue; their lines are missing from the data log and journal.
+     */
+    quint64 droppedChunks() const {
+        return _droppedChunks;
+    }
+
+    /**
+     * @brief Number of lines after the handshake that were neither the
+     *        header nor a valid sample.
+     */
+    quint64 invalidLines() const {
+        return _invalidLines;
+    }
+
+    /**
+     * @brief The channels of the current session.
+     *
+     * Only fixed once the first sample has been parsed, so it may only be
+     * read after a sample of the session was taken from samples().
+     */
+    const ChannelSchema& schema() const {
+        return _schema;
+    }
+
+    /**
+     * @brief Records every read() as a tick of PipelineStats::Read, with
+     *        the bytes read in and the samples parsed out.
+     *
+     * Must be set before the worker is moved to its thread.
+     */
+    void setStats(PipelineStats *stats) {
+        _stats = stats;
+    }
+
+    SpscQueue<Sample>& samples() {
+        return _samples;
+    }
+
+    SpscQueue<QByteArray>& rawData() {
+        return _rawData;
+    }
+
+    /**
+     * @brief When the samples of each read() were received; pushed after
+     *        the samples it describes.
+     */
+    SpscQueue<LatencyHistogram::Arrival>& arrivals() {
+        return _arrivals;
+    }
+
+public slots:
+    /**
+     * @brief Opens portName, a port name or the path of a device.
+     */
+    bool open(const QString &portName, qint32 baudRate);
+    void close();
+
+signals:
+    void arduinoStarted();
+
+private slots:
+    void read();
+
+private:
+    static const int SampleCapacity = 1 << 16;
+    static const int RawDataCapacity = 1 << 12;
+    static const int BufferCapacity = 1 << 16;
+    static const int ArrivalCapacity = 1 << 12;
+
+    std::atomic<bool> _open{false};
+    std::atomic<quint64> _droppedSamples{0};
+    std::atomic<quint64> _droppedChunks{0};
+    std::atomic<quint64> _invalidLines{0};
+    bool _arduinoReady = false;
+    bool _headerReceived = false;
+    QString _errorString;
+    ChannelSchema _schema;
+
+    QSerialPort *_serialPort;
+    QByteArray _buffer;
+    PipelineStats *_stats = nullptr;
+
+    /**
+     * @brief Arrival that did not fit into the queue yet; later ones are
+     *        added to it until it does.
+     */
+    LatencyHistogram::Arrival _pendingArrival;
+
+    SpscQueue<Sample> _samples;
+    SpscQueue<QByteArray> _rawData;
+    SpscQueue<LatencyHistogram::Arrival> _arrivals;
+};
+
+#endif // SERIALWORKER_H
@@ -0,0 +1,409 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "sessionfile.h"
+
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char FileMagic[4] = { 'M', 'P', 'T', 'S' };
+const char ChunkMagic[4] = { 'C', 'H', 'N', 'K' };
+const char IndexMagic[4] = { 'I', 'N', 'D', 'X' };
+const char FooterMagic[4] = { 'M', 'P', 'T', 'E' };
+const quint32 Version = 2;
+const quint32 FirstVersion = 1;
+
+// Magic and version; from version 2 on followed by the schema.
+const int FileHeaderSize = 8;
+const int FooterSize = 16;
+
+int chunkHeaderSize(int channels)
+{
+    return 24 + 2 * (1 + channels) * 4;
+}
+
+int indexEntrySize(int channels)
+{
+    return 8 + chunkHeaderSize(channels);
+}
+
+int sampleSize(int channels)
+{
+    return 8 + (1 + channels) * 4;
+}
+
+void putMagic(char *&p, const char *magic)
+{
+    memcpy(p, magic, 4);
+    p += 4;
+}
+
+template <typename T>
+void put(char *&p, T value)
+{
+    qToLittleEndian(value, p);
+    p += sizeof(T);
+}
+
+void putDouble(char *&p, double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put(p, bits);
+}
+
+bool getMagic(const char *&p, const char *magic)
+{
+    auto ok = memcmp(p, magic, 4) == 0;
+    p += 4;
+    return ok;
+}
+
+template <typename T>
+T get(const char *&p)
+{
+    auto value = qFromLittleEndian<T>(p);
+    p += sizeof(T);
+    return value;
+}
+
+double getDouble(const char *&p)
+{
+    auto bits = get<quint64>(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void putChunkHeader(char *&p, const SessionFile::Chunk &chunk, int channels)
+{
+    putMagic(p, ChunkMagic);
+    put(p, quint32(chunk.count));
+    putDouble(p, chunk.min.ms);
+    putDouble(p, chunk.max.ms);
+    for (auto sample: { &chunk.min, &chunk.max }) {
+        put(p, qint32(sample->sync));
+        for (int i=0; i<channels; ++i)
+            put(p, qint32(sample->values[i]));
+    }
+}
+
+bool getChunkHeader(const char *&p, SessionFile::Chunk &chunk, int channels)
+{
+    if (!getMagic(p, ChunkMagic))
+        return false;
+    chunk.count = static_cast<int>(get<quint32>(p));
+    chunk.min.ms = getDouble(p);
+    chunk.max.ms = getDouble(p);
+    for (auto sample: { &chunk.min, &chunk.max }) {
+        sample->sync = get<qint32>(p);
+        for (int i=0; i<channels; ++i)
+            sample->values[i] = get<qint32>(p);
+    }
+    return chunk.count > 0 && chunk.count <= SessionFile::ChunkSize;
+}
+
+} // namespace
+
+SessionFile::SessionFile()
+{
+
+}
+
+bool SessionFile::isSession(const char *data, qint64 size)
+{
+    return size >= FileHeaderSize && memcmp(data, FileMagic, 4) == 0;
+}
+
+SessionWriter::SessionWriter()
+{
+    _pending.reserve(SessionFile::ChunkSize);
+}
+
+SessionWriter::~SessionWriter()
+{
+    close();
+}
+
+bool SessionWriter::open(const QString &fileName, const ChannelSchema &schema)
+{
+    close();
+
+    // Chunks are written as a whole anyway; unbuffered they reach the OS
+    // right away, so the file can be read while it is still written.
+    _file.setFileName(fileName);
+    if (!_file.open(QFile::WriteOnly | QFile::Truncate | QFile::Unbuffered)) {
+        _errorString = QString("Could not open session file %1: %2")
+                .arg(fileName).arg(_file.errorString());
+        return false;
+    }
+    return start(&_file, schema);
+}
+
+bool SessionWriter::open(QFileDevice *device, const ChannelSchema &schema)
+{
+    close();
+    if (!device->isWritable()) {
+        _errorString = QString("Session file %1 is not open for writing.")
+                .arg(device->fileName());
+        return false;
+    }
+    return start(device, schema);
+}
+
+bool SessionWriter::close()
+{
+    if (!_device)
+        return true;
+
+    auto ok = writeChunk();
+    if (ok) {
+        auto indexOffset = _device->pos();
+        QByteArray index(8 + _chunks.size() * indexEntrySize(_channels) + FooterSize, '\0');
+        auto p = index.data();
+        putMagic(p, IndexMagic);
+        put(p, quint32(_chunks.size()));
+        for (auto &chunk: _chunks) {
+            put(p, quint64(chunk.offset));
+            putChunkHeader(p, chunk, _channels);
+        }
+        put(p, quint64(indexOffset));
+        put(p, quint32(_chunks.size()));
+        putMagic(p, FooterMagic);
+        ok = write(index);
+    }
+    if (_device == &_file)
+        _file.close();
+    _device = nullptr;
+    return ok;
+}
+
+bool SessionWriter::append(const Sample &sample)
+{
+    _pending.append(sample);
+    if (_pending.size() < SessionFile::ChunkSize)
+        return true;
+    return writeChunk();
+}
+
+bool SessionWriter::flush()
+{
+    return writeChunk() && _device->flush();
+}
+
+bool SessionWriter::writeChunk()
+{
+    if (_pending.isEmpty())
+        return true;
+
+    SessionFile::Chunk chunk;
+    chunk.offset = _device->pos();
+    chunk.count = _pending.size();
+    chunk.min = _pending.first();
+    chunk.max = _pending.first();
+    for (auto &sample: _pending) {
+        chunk.min.sync = qMin(chunk.min.sync, sample.sync);
+        chunk.max.sync = qMax(chunk.max.sync, sample.sync);
+        for (int i=0; i<_channels; ++i) {
+            chunk.min.values[i] = qMin(chunk.min.values[i], sample.values[i]);
+            chunk.max.values[i] = qMax(chunk.max.values[i], sample.values[i]);
+        }
+    }
+    chunk.max.ms = _pending.last().ms;
+
+    // The buffer keeps its capacity across chunks.
+    _buffer.resize(chunkHeaderSize(_channels) + chunk.count * sampleSize(_channels));
+    auto p = _buffer.data();
+    putChunkHeader(p, chunk, _channels);
+    for (auto &sample: _pending)
+        putDouble(p, sample.ms);
+    for (auto &sample: _pending)
+        put(p, qint32(sample.sync));
+    for (int i=0; i<_channels; ++i) {
+        for (auto &sample: _pending)
+            put(p, qint32(sample.values[i]));
+    }
+
+    _pending.clear();
+    if (!write(_buffer))
+        return false;
+    _chunks.append(chunk);
+    return true;
+}
+
+bool SessionWriter::start(QFileDevice *device, const ChannelSchema &schema)
+{
+    _device = device;
+    _chunks.clear();
+    _chunks.reserve(ReservedChunks);
+    _pending.clear();
+
+    auto schemaHeader = schema.header();
+    QByteArray header(FileHeaderSize + 4 + schemaHeader.size(), '\0');
+    auto p = header.data();
+    putMagic(p, FileMagic);
+    put(p, Version);
+    put(p, quint32(schemaHeader.size()));
+    memcpy(p, schemaHeader.constData(), static_cast<size_t>(schemaHeader.size()));
+    _channels = schema.count();
+    return write(header);
+}
+
+bool SessionWriter::write(const QByteArray &data)
+{
+    if (_device->write(data) == data.size())
+        return true;
+    _errorString = QString("Could not write session file %1: %2")
+            .arg(_device->fileName()).arg(_device->errorString());
+    return false;
+}
+
+SessionReader::SessionReader()
+{
+
+}
+
+bool SessionReader::open(const char *data, qint64 size)
+{
+    close();
+    if (!SessionFile::isSession(data, size)) {
+        _errorString = "Not a session file.";
+        return false;
+    }
+    auto p = data + 4;
+    auto version = get<quint32>(p);
+    if (version < FirstVersion || version > Version) {
+        _errorString = "Unsupported session file version.";
+        return false;
+    }
+
+    _schema = ChannelSchema();
+    _firstChunk = FileHeaderSize;
+    if (version > FirstVersion) {
+        auto length = size >= FileHeaderSize + 4 ? qint64(get<quint32>(p)) : -1;
+        if (length < 0 || FileHeaderSize + 4 + length > size ||
+                !ChannelSchema::fromHeader(p, p + length, _schema)) {
+            _errorString = "Invalid session file schema.";
+            return false;
+        }
+        _firstChunk = FileHeaderSize + 4 + length;
+    }
+
+    _data = data;
+    _size = size;
+    if (!readIndex())
+        scanChunks();
+
+    for (auto &chunk: _chunks)
+        _sampleCount += chunk.count;
+    _errorString.clear();
+    return true;
+}
+
+void SessionReader::close()
+{
+    _data = nullptr;
+    _size = 0;
+    _firstChunk = 0;
+    _sampleCount = 0;
+    _chunks.clear();
+}
+
+int SessionReader::findChunk(qreal ms) const
+{
+    auto chunk = std::lower_bound(_chunks.begin(), _chunks.end(), ms,
+                                  [](const SessionFile::Chunk &chunk, qreal ms) {
+        return chunk.max.ms < ms;
+    });
+    return static_cast<int>(chunk - _chunks.begin());
+}
+
+void SessionReader::read(int chunk, QVector<Sample> &samples) const
+{
+    auto &info = _chunks[chunk];
+    auto count = info.count;
+    auto first = samples.size();
+    samples.resize(first + count);
+    auto rows = samples.data() + first;
+
+    auto channels = _schema.count();
+    auto p = _data + info.offset + chunkHeaderSize(channels);
+    for (int i=0; i<count; ++i)
+        rows[i].ms = getDouble(p);
+    for (int i=0; i<count; ++i)
+        rows[i].sync = get<qint32>(p);
+    for (int channel=0; channel<channels; ++channel) {
+        for (int i=0; i<count; ++i)
+            rows[i].values[channel] = get<qint32>(p);
+    }
+}
+
+bool SessionReader::readIndex()
+{
+    auto channels = _schema.count();
+    if (_size < _firstChunk + 8 + FooterSize)
+        return false;
+
+    auto p = _data + _size - FooterSize;
+    auto indexOffset = static_cast<qint64>(get<quint64>(p));
+    auto count = static_cast<qint64>(get<quint32>(p));
+    if (!getMagic(p, FooterMagic) || indexOffset < _firstChunk ||
+            indexOffset + 8 + count * indexEntrySize(channels) + FooterSize != _size)
+        return false;
+
+    p = _data + indexOffset;
+    if (!getMagic(p, IndexMagic) || get<quint32>(p) != count)
+        return false;
+
+    _chunks.resize(static_cast<int>(count));
+    for (auto &chunk: _chunks) {
+        chunk.offset = static_cast<qint64>(get<quint64>(p));
+        if (!getChunkHeader(p, chunk, channels) || chunk.offset < _firstChunk ||
+                chunk.offset + chunkHeaderSize(channels) + chunk.count * sampleSize(channels) > indexOffset) {
+            _chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void SessionReader::scanChunks()
+{
+    // Without index every complete chunk is used; a partly written chunk at
+    // the end is dropped.
+    _chunks.clear();
+    auto headerSize = chunkHeaderSize(_schema.count());
+    auto rowSize = sampleSize(_schema.count());
+    auto offset = _firstChunk;
+    while (offset + headerSize <= _size) {
+        SessionFile::Chunk chunk;
+        chunk.offset = offset;
+        auto p = _data + offset;
+        if (!getChunkHeader(p, chunk, _schema.count()) ||
+                offset + headerSize + chunk.count * rowSize > _size)
+            break;
+        _chunks.append(chunk);
+        offset += headerSize + chunk.count * rowSize;
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include "channelschema.h"
+#include "sample.h"
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Native binary recording format (*.mpts).
+ *
+ * All values are little endian. The file starts with a header holding the
+ * CSV header line of its ChannelSchema and is followed by chunks of at
+ * most ChunkSize samples. Every chunk starts with its own header holding
+ * the number of samples, the time range and the minimum and maximum of
+ * every column; the samples follow column by column: ms as doubles, then
+ * sync and every channel as 32 bit integers. An index with all chunk
+ * headers and a footer pointing at it end the file. Files of version 1
+ * have no schema and always hold the channels of the default schema.
+ *
+ * Chunks are written as soon as they are complete, so a recording can be
+ * written during acquisition. A file without index, e.g. after a crash,
+ * is still read by walking the chunk headers.
+ */
+class SessionFile final
+{
+private:
+    SessionFile();
+
+public:
+    static const int ChunkSize = 4096;
+
+    /**
+     * @brief The header of one chunk.
+     */
+    struct Chunk {
+        qint64 offset;  ///< Of the chunk header in the file.
+        int count;
+        Sample min;     ///< Column-wise minimum; ms is the first time.
+        Sample max;     ///< Column-wise maximum; ms is the last time.
+    };
+
+    static bool isSession(const char *data, qint64 size);
+};
+
+Q_DECLARE_TYPEINFO(SessionFile::Chunk, Q_PRIMITIVE_TYPE);
+
+/**
+ * @brief Writes a session chunk by chunk.
+ */
+class SessionWriter final
+{
+public:
+    SessionWriter();
+    ~SessionWriter();
+
+    bool open(const QString &fileName, const ChannelSchema &schema = ChannelSchema());
+
+    /**
+     * @brief Writes to device, which is open for writing and stays owned by
+     *        the caller, e.g. a QSaveFile to commit once close() succeeded.
+     */
+    bool open(QFileDevice *device, const ChannelSchema &schema = ChannelSchema());
+
+    /**
+     * @brief Writes the pending samples and the index and closes the file;
+     *        a device passed to open() is left open.
+     */
+    bool close();
+
+    bool isOpen() const {
+        return _device != nullptr;
+    }
+
+    bool append(const Sample &sample);
+
+    /**
+     * @brief Writes the pending samples as a chunk of their own and flushes
+     *        the file, so they survive a crash.
+     */
+    bool flush();
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+private:
+    /**
+     * @brief Chunks the index has room for right after open(), about four
+     *        million samples; appending them does not allocate.
+     */
+    static const int ReservedChunks = 1024;
+
+    bool start(QFileDevice *device, const ChannelSchema &schema);
+    bool writeChunk();
+    bool write(const QByteArray &data);
+
+    QFile _file;
+    QFileDevice *_device = nullptr;
+    QString _errorString;
+    int _channels = 0;
+    QVector<Sample> _pending;
+    QVector<SessionFile::Chunk> _chunks;
+    QByteArray _buffer;
+};
+
+/**
+ * @brief Reads a session from memory, typically a mapped file.
+ *
+ * Opening only reads the index; the samples of a chunk are decoded on
+ * demand, so the chunks needed for a time range can be read without
+ * touching the rest of the file.
+ */
+class SessionReader final
+{
+public:
+    SessionReader();
+
+    bool open(const char *data, qint64 size);
+    void close();
+
+    const QVector<SessionFile::Chunk>& chunks() const {
+        return _chunks;
+    }
+
+    qint64 sampleCount() const {
+        return _sampleCount;
+    }
+
+    const ChannelSchema& schema() const {
+        return _schema;
+    }
+
+    /**
+     * @brief Index of the first chunk that ends at or after ms.
+     */
+    int findChunk(qreal ms) const;
+
+    /**
+     * @brief Appends the samples of the chunk to samples.
+     */
+    void read(int chunk, QVector<Sample> &samples) const;
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+private:
+    bool readIndex();
+    void scanChunks();
+
+    const char *_data = nullptr;
+    qint64 _size = 0;
+    qint64 _firstChunk = 0;
+    qint64 _sampleCount = 0;
+    ChannelSchema _schema;
+    QVector<SessionFile::Chunk> _chunks;
+    QString _errorString;
+};
+
+#endif // SESSIONFILE_H
@@ -0,0 +1,96 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "significanceindex.h"
+
+#include <limits>
+
+SignificanceIndex::SignificanceIndex()
+{
+
+}
+
+void SignificanceIndex::clear()
+{
+    _sealed = 0;
+    _values.clear();
+}
+
+void SignificanceIndex::reserve(int size)
+{
+    // Fed a tick at a time, the open block stays below twice BlockSize
+    // samples, and the stack never holds more ranges than samples.
+    _values.reserve(size);
+    _stack.reserve(2 * BlockSize);
+}
+
+void SignificanceIndex::rebuild(const ChannelView &data)
+{
+    clear();
+    if (data.isEmpty())
+        return;
+    _values.resize(data.size());
+    DouglasPeucker::parallelSignificance(data, 0, data.size()-1, _values);
+    _sealed = data.size() - 1;
+}
+
+void SignificanceIndex::update(const ChannelView &data)
+{
+    if (data.size() < _values.size())
+        clear();
+    if (data.size() == _values.size())
+        return;
+
+    auto last = data.size() - 1;
+    _values.resize(data.size());
+    DouglasPeucker::significance(data, _sealed, last, _values, _stack);
+    if (last - _sealed >= BlockSize)
+        _sealed = last;
+}
+
+void SignificanceIndex::removeFirst(const ChannelView &data, int count)
+{
+    count = qMin(count, _values.size());
+    _values.remove(0, count);
+    _sealed = qMax(_sealed - count, 0);
+    if (_values.isEmpty())
+        return;
+
+    // Block boundaries are the only samples of infinite significance, and
+    // the blocks after the first one never looked beyond them.
+    auto end = 1;
+    while (end < _values.size() - 1 &&
+           _values[end] < std::numeric_limits<qreal>::max())
+        ++end;
+    DouglasPeucker::significance(data, 0, qMin(end, _values.size() - 1),
+                                 _values, _stack);
+}
+
+void SignificanceIndex::filter(const ChannelView &data, int last, qreal epsilon,
+                               QVector<QPointF> &result) const
+{
+    result.clear();
+    last = qMin(last, _values.size() - 1);
+    auto epsilon2 = epsilon * epsilon;
+    for (int i=0; i<=last; ++i) {
+        if (_values[i] > epsilon2)
+            result.append(data[i]);
+    }
+}
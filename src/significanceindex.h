@@ -0,0 +1,88 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SIGNIFICANCEINDEX_H
+#define SIGNIFICANCEINDEX_H
+
+#include "douglaspeucker.h"
+
+#include <QVector>
+#include <QPointF>
+
+/**
+ * @brief Douglas-Peucker significance of every sample of a growing buffer.
+ *
+ * The values are computed once per data set, so simplifying for another
+ * epsilon is a linear filter instead of a full recomputation. Samples that
+ * are appended later are covered block-wise: only the open block after the
+ * last sealed sample is recomputed, and block boundaries are always kept.
+ * The result therefore stays within epsilon of the samples but may keep a
+ * few more points than a batch run over the whole buffer.
+ */
+class SignificanceIndex final
+{
+public:
+    SignificanceIndex();
+
+    void clear();
+
+    const QVector<qreal>& values() const {
+        return _values;
+    }
+
+    /**
+     * @brief Index of the last sample that will not be recomputed anymore.
+     */
+    int sealed() const {
+        return _sealed;
+    }
+
+    /**
+     * @brief Allocates the values for size samples and the scratch space
+     *        of update().
+     */
+    void reserve(int size);
+
+    void rebuild(const ChannelView &data);
+    void update(const ChannelView &data);
+
+    /**
+     * @brief Drops the values of the first count samples, which data no
+     *        longer contains.
+     *
+     * Only the block the cut went through is recomputed, so trimming a
+     * buffer fed by update() costs about a block instead of a rebuild()
+     * and does not allocate. After rebuild() the whole buffer is a single
+     * block.
+     */
+    void removeFirst(const ChannelView &data, int count);
+
+    void filter(const ChannelView &data, int last, qreal epsilon,
+                QVector<QPointF> &result) const;
+
+private:
+    static const int BlockSize = 4096;
+
+    int _sealed = 0;
+    QVector<qreal> _values;
+    QVector<DouglasPeucker::Range> _stack;
+};
+
+#endif // SIGNIFICANCEINDEX_H
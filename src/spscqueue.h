@@ -0,0 +1,106 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer and one consumer.
+ *
+ * The capacity is rounded up to a power of two. Neither push() nor pop()
+ * ever blocks or allocates; push() fails if the queue is full.
+ */
+template <typename T>
+class SpscQueue final
+{
+public:
+    explicit SpscQueue(int capacity)
+        : _capacity(roundUp(capacity))
+        , _mask(_capacity - 1)
+        , _items(new T[static_cast<size_t>(_capacity)])
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue& operator=(const SpscQueue &) = delete;
+
+    int capacity() const {
+        return _capacity;
+    }
+
+    /**
+     * @brief Number of queued items; only a snapshot for the other thread.
+     */
+    int size() const {
+        return static_cast<int>(_tail.load(std::memory_order_acquire)
+                                - _head.load(std::memory_order_acquire));
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Called by the producer only.
+     */
+    bool push(const T &item) {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == static_cast<quint64>(_capacity))
+            return false;
+        _items[tail & _mask] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Called by the consumer only.
+     */
+    bool pop(T &item) {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        item = std::move(_items[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static int roundUp(int capacity) {
+        int result = 1;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    const int _capacity;
+    const quint64 _mask;
+    std::unique_ptr<T[]> _items;
+
+    // Producer and consumer write different cache lines.
+    alignas(64) std::atomic<quint64> _head{0};
+    alignas(64) std::atomic<quint64> _tail{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,121 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "streamgenerator.h"
+
+#include <QtMath>
+
+StreamGenerator::StreamGenerator(int rate, int channels, qreal noise, quint32 seed)
+    : _rate(qMax(1, rate))
+    , _channels(qBound(1, channels, int(Sample::MaxChannels)))
+    , _noise(noise)
+    , _seed(seed ? seed : 1)
+    , _state(_seed)
+{
+
+}
+
+ChannelSchema StreamGenerator::schema() const
+{
+    QStringList names;
+    for (int i=0; i<_channels-1; ++i)
+        names.append(QString("air%1").arg(i+1));
+    names.append(_channels > 1 ? QString("pulse") : QString("air1"));
+    return ChannelSchema(names);
+}
+
+Sample StreamGenerator::next()
+{
+    Sample sample;
+    sample.ms = _index * 1000.0 / _rate;
+    auto seconds = sample.ms / 1000.0;
+    for (int i=0; i<_channels; ++i) {
+        auto value = (i < _channels-1 || _channels == 1)
+                ? breathing(i, seconds) : pulse(seconds);
+        value += gaussian();
+        sample.values[i] = qBound(0, qRound(value), 1023);
+    }
+    ++_index;
+    return sample;
+}
+
+QByteArray StreamGenerator::lines(int count)
+{
+    QByteArray data;
+    data.reserve(count * (12 + 5 * _channels));
+    for (int i=0; i<count; ++i) {
+        auto sample = next();
+        data.append(QByteArray::number(qRound64(sample.ms))).append(',');
+        data.append(QByteArray::number(sample.sync));
+        for (int j=0; j<_channels; ++j)
+            data.append(',').append(QByteArray::number(sample.values[j]));
+        data.append("\r\n");
+    }
+    return data;
+}
+
+QByteArray StreamGenerator::csv(qreal seconds)
+{
+    _index = 0;
+    _state = _seed;
+    auto data = schema().header();
+    data.append("\r\n");
+    data.append(lines(static_cast<int>(samples(seconds))));
+    return data;
+}
+
+qreal StreamGenerator::breathing(int channel, qreal seconds) const
+{
+    // About 15 breaths a minute on a slowly wandering base line.
+    auto period = 4.0 + 0.3 * channel;
+    auto drift = 5.0 * qSin(2.0 * M_PI * seconds / 60.0);
+    return 300.0 + drift + 40.0 * qSin(2.0 * M_PI * seconds / period + channel);
+}
+
+qreal StreamGenerator::pulse(qreal seconds) const
+{
+    // A sharp systolic peak followed by a small dicrotic one, 72 bpm.
+    auto period = 60.0 / 72.0;
+    auto phase = std::fmod(seconds, period) / period;
+    auto systolic = (phase - 0.2) / 0.03;
+    auto dicrotic = (phase - 0.4) / 0.05;
+    return 500.0 + 150.0 * qExp(-systolic * systolic)
+            + 30.0 * qExp(-dicrotic * dicrotic);
+}
+
+qreal StreamGenerator::gaussian()
+{
+    // The sum of four uniform numbers is close enough to normal; its
+    // standard deviation is 1/sqrt(3).
+    qreal sum = 0.0;
+    for (int i=0; i<4; ++i)
+        sum += random() / 4294967296.0;
+    return (sum - 2.0) * qSqrt(3.0) * _noise;
+}
+
+quint32 StreamGenerator::random()
+{
+    // xorshift32; the same on every platform, unlike <random>'s
+    // distributions.
+    _state ^= _state << 13;
+    _state ^= _state >> 17;
+    _state ^= _state << 5;
+    return _state;
+}
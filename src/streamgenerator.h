@@ -0,0 +1,100 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef STREAMGENERATOR_H
+#define STREAMGENERATOR_H
+
+#include "channelschema.h"
+#include "sample.h"
+
+#include <QByteArray>
+
+/**
+ * @brief Synthetic output of the Arduino board for benchmarks and the
+ *        serial simulator.
+ *
+ * All channels but the last are breathing curves with slightly different
+ * periods; the last one is a pulse curve. Both get approximately normal
+ * noise and are clamped to the 10 bit range of the board's ADC. The
+ * stream is deterministic for a given seed, so runs can be compared.
+ */
+class StreamGenerator final
+{
+public:
+    /**
+     * @brief rate samples per second of channels channels, with noise as
+     *        standard deviation of the noise.
+     */
+    StreamGenerator(int rate = 200, int channels = 4, qreal noise = 2.0,
+                    quint32 seed = 1);
+
+    int rate() const {
+        return _rate;
+    }
+
+    int channelCount() const {
+        return _channels;
+    }
+
+    qreal noise() const {
+        return _noise;
+    }
+
+    /**
+     * @brief air1, air2, ... and pulse; the default schema for four
+     *        channels.
+     */
+    ChannelSchema schema() const;
+
+    /**
+     * @brief Number of samples in seconds of the stream.
+     */
+    qint64 samples(qreal seconds) const {
+        return static_cast<qint64>(seconds * _rate);
+    }
+
+    Sample next();
+
+    /**
+     * @brief The next count samples as CSV lines, each terminated by
+     *        "\r\n" like the board's println().
+     */
+    QByteArray lines(int count);
+
+    /**
+     * @brief The header line and seconds of the stream from its start.
+     */
+    QByteArray csv(qreal seconds);
+
+private:
+    qreal breathing(int channel, qreal seconds) const;
+    qreal pulse(qreal seconds) const;
+    qreal gaussian();
+    quint32 random();
+
+    int _rate;
+    int _channels;
+    qreal _noise;
+    quint32 _seed;
+    quint32 _state;
+    qint64 _index = 0;
+};
+
+#endif // STREAMGENERATOR_H
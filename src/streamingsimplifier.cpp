@@ -0,0 +1,91 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "streamingsimplifier.h"
+
+#include <algorithm>
+
+StreamingSimplifier::StreamingSimplifier()
+{
+
+}
+
+void StreamingSimplifier::clear()
+{
+    _anchor = 0;
+    _frozen = 0;
+    _unchanged = 0;
+    _result.clear();
+}
+
+void StreamingSimplifier::setEpsilon(qreal epsilon)
+{
+    if (_epsilon == epsilon)
+        return;
+    _epsilon = epsilon;
+    clear();
+}
+
+void StreamingSimplifier::restart(const QVector<QPointF> &vertices, int anchor)
+{
+    if (vertices.isEmpty()) {
+        clear();
+        return;
+    }
+    // Copied instead of shared, so the next update() does not detach.
+    _result.resize(vertices.size());
+    std::copy(vertices.cbegin(), vertices.cend(), _result.begin());
+    _frozen = vertices.size();
+    _anchor = anchor;
+    _unchanged = 0;
+}
+
+const QVector<QPointF>& StreamingSimplifier::update(const ChannelView &data)
+{
+    // The buffer was cleared or replaced behind our back; start over.
+    if (_anchor >= data.size() ||
+            (_frozen > 0 && _result[_frozen-1] != data[_anchor]))
+        clear();
+
+    if (data.isEmpty())
+        return _result;
+
+    auto last = data.size() - 1;
+    DouglasPeucker::douglasPeucker(data, _anchor, last, _epsilon, _indices, _stack);
+
+    // The anchor itself is already the last frozen vertex.
+    _result.resize(_frozen);
+    _unchanged = qMin(_unchanged, _frozen);
+    for (int i=_frozen > 0 ? 1 : 0; i<_indices.size(); ++i)
+        _result.append(data[_indices[i]]);
+
+    // Freeze everything but the last segment; it may still change once more
+    // samples arrive. A tail without any interior vertex is frozen as a whole
+    // as soon as it exceeds MaxTail.
+    if (_indices.size() > 2) {
+        _frozen = _result.size() - 1;
+        _anchor = _indices[_indices.size()-2];
+    } else if (last - _anchor >= MaxTail) {
+        _frozen = _result.size();
+        _anchor = last;
+    }
+
+    return _result;
+}
@@ -0,0 +1,100 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef STREAMINGSIMPLIFIER_H
+#define STREAMINGSIMPLIFIER_H
+
+#include "douglaspeucker.h"
+
+#include <QVector>
+#include <QPointF>
+
+/**
+ * @brief Incremental Ramer-Douglas-Peucker simplification of a growing buffer.
+ *
+ * The simplified polyline is split into a frozen prefix and an open tail.
+ * Each update only simplifies the samples after the last frozen vertex, so
+ * the cost per update is proportional to the number of new samples instead
+ * of the length of the whole buffer. Every frozen segment was accepted by
+ * the Douglas-Peucker criterion, so all samples stay within epsilon of the
+ * result, just as with the batch algorithm.
+ */
+class StreamingSimplifier final
+{
+public:
+    StreamingSimplifier();
+
+    void clear();
+
+    qreal epsilon() const {
+        return _epsilon;
+    }
+
+    void setEpsilon(qreal epsilon);
+
+    /**
+     * @brief Continues from an already simplified prefix of the data.
+     *
+     * vertices becomes the frozen prefix and has to end with data[anchor];
+     * the next update() only simplifies the samples after anchor.
+     */
+    void restart(const QVector<QPointF> &vertices, int anchor);
+
+    const QVector<QPointF>& result() const {
+        return _result;
+    }
+
+    const QVector<QPointF>& update(const ChannelView &data);
+
+    /**
+     * @brief Number of leading vertices of result() that did not change
+     *        since the last markUnchanged().
+     *
+     * Only the vertices after them have to be redrawn; all of them if the
+     * simplifier was cleared or restarted in the meantime.
+     */
+    int unchanged() const {
+        return _unchanged;
+    }
+
+    void markUnchanged() {
+        _unchanged = _result.size();
+    }
+
+private:
+    /**
+     * @brief Upper bound for the open tail in samples.
+     *
+     * A straight or flat signal never produces interior vertices; without
+     * this bound the tail would grow with the session again.
+     */
+    static const int MaxTail = 4096;
+
+    qreal _epsilon = 2.0;
+    int _anchor = 0;
+    int _frozen = 0;
+    int _unchanged = 0;
+
+    QVector<QPointF> _result;
+    QVector<int> _indices;
+    QVector<DouglasPeucker::Range> _stack;
+};
+
+#endif // STREAMINGSIMPLIFIER_H
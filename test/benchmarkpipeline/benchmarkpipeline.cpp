@@ -0,0 +1,358 @@
+#include <QtTest>
+#include <QApplication>
+#include <QChart>
+#include <QGraphicsScene>
+#include <QLineSeries>
+#include <QPainter>
+#include <QValueAxis>
+
+#include "../../src/csvparser.h"
+#include "../../src/douglaspeucker.h"
+#include "../../src/lodpyramid.h"
+#include "../../src/rasterplotitem.h"
+#include "../../src/samplestore.h"
+#include "../../src/serialreader.h"
+#include "../../src/significanceindex.h"
+#include "../../src/streamgenerator.h"
+#include "../../src/streamingsimplifier.h"
+
+QT_CHARTS_USE_NAMESPACE
+
+/**
+ * @brief Benchmarks of the stages between the serial port and the chart
+ *        for sessions of one minute, one hour and ten hours.
+ */
+class BenchmarkPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    BenchmarkPipeline();
+    ~BenchmarkPipeline();
+
+private slots:
+    void benchmarkDouglasPeucker_data();
+    void benchmarkDouglasPeucker();
+    void benchmarkLoad_data();
+    void benchmarkLoad();
+    void benchmarkIngest_data();
+    void benchmarkIngest();
+    void benchmarkSeriesUpdate_data();
+    void benchmarkSeriesUpdate();
+    void benchmarkPaint_data();
+    void benchmarkPaint();
+
+private:
+    /**
+     * @brief What SerialReader keeps per channel of a live session.
+     */
+    struct Channel {
+        SignificanceIndex significance;
+        LodPyramid pyramid;
+        StreamingSimplifier simplifier;
+    };
+
+    struct Session {
+        StreamGenerator generator;
+        SampleStore store;
+        QVector<Channel> channels;
+    };
+
+    static const int FrameRate = 30;
+
+    /**
+     * @brief Full HD, the size of a maximized chart.
+     */
+    static const int PaintWidth = 1920;
+    static const int PaintHeight = 1080;
+
+    static void addScales();
+    static void start(Session &session, int channels, qreal seconds);
+    static void ingestFrame(Session &session);
+};
+
+BenchmarkPipeline::BenchmarkPipeline()
+{
+
+}
+
+BenchmarkPipeline::~BenchmarkPipeline()
+{
+
+}
+
+void BenchmarkPipeline::benchmarkDouglasPeucker_data()
+{
+    addScales();
+}
+
+void BenchmarkPipeline::benchmarkDouglasPeucker()
+{
+    QFETCH(qreal, seconds);
+
+    StreamGenerator generator;
+    ChannelBuffer buffer;
+    auto count = generator.samples(seconds);
+    buffer.reserve(static_cast<int>(count));
+    for (qint64 i=0; i<count; ++i) {
+        auto sample = generator.next();
+        buffer.append(sample.ms, sample.values[0]);
+    }
+
+    QVector<QPointF> result;
+    QBENCHMARK {
+        DouglasPeucker::douglasPeucker(buffer, 2.0, result);
+    }
+    QVERIFY(result.size() > 1);
+}
+
+void BenchmarkPipeline::benchmarkLoad_data()
+{
+    addScales();
+}
+
+void BenchmarkPipeline::benchmarkLoad()
+{
+    QFETCH(qreal, seconds);
+
+    // Parsing, building the indices and simplifying the whole file.
+    auto csv = StreamGenerator().csv(seconds);
+    QValueAxis axisX;
+    SerialReader reader;
+    reader.setAxisX(&axisX);
+    QBENCHMARK {
+        reader.load(csv);
+    }
+    QVERIFY(reader.series(0)->count() > 1);
+}
+
+void BenchmarkPipeline::benchmarkIngest_data()
+{
+    QTest::addColumn<qreal>("seconds");
+    QTest::addColumn<int>("channels");
+
+    QTest::addRow("1 min") << 60.0 << 4;
+    QTest::addRow("1 h") << 3600.0 << 4;
+    QTest::addRow("10 h") << 36000.0 << 4;
+    QTest::addRow("1 h, 16 channels") << 3600.0 << 16;
+}
+
+void BenchmarkPipeline::benchmarkIngest()
+{
+    QFETCH(qreal, seconds);
+    QFETCH(int, channels);
+
+    // The cost of a frame should not depend on the length of the session.
+    Session session;
+    start(session, channels, seconds);
+    QBENCHMARK {
+        ingestFrame(session);
+    }
+}
+
+void BenchmarkPipeline::benchmarkSeriesUpdate_data()
+{
+    QTest::addColumn<qreal>("seconds");
+    QTest::addColumn<bool>("tail");
+
+    QTest::addRow("1 min, replace") << 60.0 << false;
+    QTest::addRow("1 min, tail") << 60.0 << true;
+    QTest::addRow("1 h, replace") << 3600.0 << false;
+    QTest::addRow("1 h, tail") << 3600.0 << true;
+    QTest::addRow("10 h, replace") << 36000.0 << false;
+    QTest::addRow("10 h, tail") << 36000.0 << true;
+}
+
+void BenchmarkPipeline::benchmarkSeriesUpdate()
+{
+    QFETCH(qreal, seconds);
+    QFETCH(bool, tail);
+
+    Session session;
+    start(session, 1, seconds);
+    auto &simplifier = session.channels[0].simplifier;
+
+    // In a chart, so the series' geometry is updated as when it is shown.
+    QChart chart;
+    auto series = new QLineSeries;
+    chart.addSeries(series);
+    chart.createDefaultAxes();
+    series->replace(simplifier.result());
+    simplifier.markUnchanged();
+
+    // Either the whole polyline each frame or only its tail, like
+    // SerialReader::updateSeries().
+    QBENCHMARK {
+        ingestFrame(session);
+        auto &result = simplifier.result();
+        if (tail) {
+            auto unchanged = simplifier.unchanged();
+            if (series->count() > unchanged)
+                series->removePoints(unchanged, series->count() - unchanged);
+            for (int i=unchanged; i<result.size(); ++i)
+                series->append(result[i]);
+        } else {
+            series->replace(result);
+        }
+        simplifier.markUnchanged();
+    }
+    QCOMPARE(series->count(), simplifier.result().size());
+}
+
+void BenchmarkPipeline::benchmarkPaint_data()
+{
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<bool>("raster");
+
+    QTest::addRow("4 channels, series") << 4 << false;
+    QTest::addRow("4 channels, raster") << 4 << true;
+    QTest::addRow("8 channels, series") << 8 << false;
+    QTest::addRow("8 channels, raster") << 8 << true;
+}
+
+void BenchmarkPipeline::benchmarkPaint()
+{
+    QFETCH(int, channels);
+    QFETCH(bool, raster);
+
+    Session session;
+    start(session, channels, 600.0);
+
+    // The chart as the main window shows it, scrolling along with the last
+    // minute of a ten minute session.
+    QGraphicsScene scene;
+    auto chart = new QChart;
+    scene.addItem(chart);
+    scene.setSceneRect(0, 0, PaintWidth, PaintHeight);
+    chart->setGeometry(scene.sceneRect());
+    auto axisX = new QValueAxis;
+    auto axisY = new QValueAxis;
+    axisY->setRange(0, 1024);
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    QVector<QXYSeries*> series;
+    for (int i=0; i<channels; ++i) {
+        auto line = new QLineSeries;
+        chart->addSeries(line);
+        line->attachAxis(axisX);
+        line->attachAxis(axisY);
+        series.append(line);
+    }
+    // Owned by the chart, like the one of the main window.
+    auto item = raster ? new RasterPlotItem(chart, axisX, axisY) : nullptr;
+    if (item)
+        item->setSeries(series);
+    QTRY_VERIFY(chart->plotArea().width() > PaintWidth / 2);
+
+    // Like SerialReader::updateSeries(): the series get their tail, the
+    // item copies it; the item draws the channels instead of the series.
+    auto update = [&] {
+        for (int i=0; i<channels; ++i) {
+            auto &simplifier = session.channels[i].simplifier;
+            auto &result = simplifier.result();
+            auto unchanged = simplifier.unchanged();
+            if (raster) {
+                item->setPoints(i, result, unchanged);
+            } else {
+                auto line = series[i];
+                if (line->count() > unchanged)
+                    line->removePoints(unchanged, line->count() - unchanged);
+                for (int j=unchanged; j<result.size(); ++j)
+                    line->append(result[j]);
+            }
+            simplifier.markUnchanged();
+        }
+        auto last = session.store.channel(0).last().x();
+        axisX->setRange(last - 60000.0, last);
+    };
+
+    QImage image(PaintWidth, PaintHeight, QImage::Format_ARGB32_Premultiplied);
+    auto paint = [&] {
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        scene.render(&painter);
+    };
+
+    update();
+    paint();
+    QBENCHMARK {
+        ingestFrame(session);
+        update();
+        paint();
+    }
+}
+
+void BenchmarkPipeline::addScales()
+{
+    QTest::addColumn<qreal>("seconds");
+
+    QTest::addRow("1 min") << 60.0;
+    QTest::addRow("1 h") << 3600.0;
+    QTest::addRow("10 h") << 36000.0;
+}
+
+void BenchmarkPipeline::start(Session &session, int channels, qreal seconds)
+{
+    // The samples so far are appended at once; the indices and the
+    // simplifier are set up as after SerialReader::trim().
+    session.generator = StreamGenerator(200, channels);
+    auto count = session.generator.samples(seconds);
+    session.store.setChannelCount(channels);
+    session.store.reserve(static_cast<int>(count));
+    for (qint64 i=0; i<count; ++i)
+        session.store.append(session.generator.next());
+
+    session.channels.resize(channels);
+    for (int i=0; i<channels; ++i) {
+        auto &channel = session.channels[i];
+        auto data = session.store.channel(i);
+        channel.significance.rebuild(data);
+        channel.pyramid.update(data);
+
+        QVector<QPointF> prefix;
+        auto sealed = channel.significance.sealed();
+        channel.significance.filter(data, sealed, 2.0, prefix);
+        channel.simplifier.restart(prefix, sealed);
+        channel.simplifier.update(data);
+    }
+}
+
+void BenchmarkPipeline::ingestFrame(Session &session)
+{
+    // The lines of one frame go the way of SerialWorker::read(),
+    // SerialReader::read() and SerialReader::render(); the channels one
+    // after the other.
+    auto lines = session.generator.lines(session.generator.rate() / FrameRate);
+    auto channels = session.generator.channelCount();
+    Sample sample;
+    CsvParser::forEachLine(lines.constData(), lines.constData() + lines.size(),
+                           [&](const char *begin, const char *end) {
+        if (CsvParser::parse(begin, end, channels, sample))
+            session.store.append(sample);
+    });
+
+    for (int i=0; i<channels; ++i) {
+        auto &channel = session.channels[i];
+        auto data = session.store.channel(i);
+        channel.significance.update(data);
+        channel.pyramid.update(data);
+        channel.simplifier.update(data);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Axes and series need fonts and pens; on machines without a display
+    // run with -platform offscreen.
+    QApplication app(argc, argv);
+    BenchmarkPipeline benchmark;
+
+    // Unless told otherwise, the results are written to a CSV file as well,
+    // so runs before and after a change can be compared by script.
+    auto arguments = app.arguments();
+    if (!arguments.contains("-o"))
+        arguments << "-o" << "-,txt" << "-o" << "benchmarkpipeline.csv,csv";
+    return QTest::qExec(&benchmark, arguments);
+}
+
+#include "benchmarkpipeline.moc"
@@ -0,0 +1,51 @@
+QT += testlib widgets charts serialport concurrent
+
+# A benchmark rather than a test case; make check does not run it.
+CONFIG += qt console warn_on depend_includepath c++14
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/channelview.h \
+    ../../src/csvparser.h \
+    ../../src/distancekernel.h \
+    ../../src/douglaspeucker.h \
+    ../../src/latencyhistogram.h \
+    ../../src/lodpyramid.h \
+    ../../src/minmaxdecimator.h \
+    ../../src/pipelinestats.h \
+    ../../src/rasterplotitem.h \
+    ../../src/renderscheduler.h \
+    ../../src/sample.h \
+    ../../src/samplehistory.h \
+    ../../src/samplestore.h \
+    ../../src/serialreader.h \
+    ../../src/serialworker.h \
+    ../../src/sessionfile.h \
+    ../../src/significanceindex.h \
+    ../../src/spscqueue.h \
+    ../../src/streamgenerator.h \
+    ../../src/streamingsimplifier.h
+
+SOURCES +=  \
+    benchmarkpipeline.cpp  \
+    ../../src/channelschema.cpp \
+    ../../src/csvparser.cpp \
+    ../../src/distancekernel.cpp \
+    ../../src/douglaspeucker.cpp \
+    ../../src/latencyhistogram.cpp \
+    ../../src/lodpyramid.cpp \
+    ../../src/minmaxdecimator.cpp \
+    ../../src/pipelinestats.cpp \
+    ../../src/rasterplotitem.cpp \
+    ../../src/renderscheduler.cpp \
+    ../../src/samplehistory.cpp \
+    ../../src/samplestore.cpp \
+    ../../src/serialreader.cpp \
+    ../../src/serialworker.cpp \
+    ../../src/sessionfile.cpp \
+    ../../src/significanceindex.cpp \
+    ../../src/streamgenerator.cpp \
+    ../../src/streamingsimplifier.cpp
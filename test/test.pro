@@ -1,4 +1,26 @@
 TEMPLATE = subdirs
 
 SUBDIRS += \
-    testdouglaspeucker
+    benchmarkpipeline \
+    testcapturejournal \
+    testchannelschema \
+    testcsvparser \
+    testdatalogmodel \
+    testdistancekernel \
+    testdouglaspeucker \
+    testlatencyhistogram \
+    testlodpyramid \
+    testminmaxdecimator \
+    testpipelinestats \
+    testrasterplotitem \
+    testrecordingloader \
+    testrenderscheduler \
+    testsamplehistory \
+    testsamplestore \
+    testsessionfile \
+    testsignificanceindex \
+    testspscqueue \
+    teststreamingsimplifier
+
+# Reads from a pseudo terminal.
+unix: SUBDIRS += testacquisitiontick
@@ -0,0 +1,207 @@
+#include <QtTest>
+
+#include "../../src/rasterplotitem.h"
+#include "../../src/serialreader.h"
+#include "../../src/streamgenerator.h"
+
+#include <QChart>
+#include <QValueAxis>
+
+#include <atomic>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Heap allocations of the threads that enabled counting.
+thread_local bool counting = false;
+std::atomic<qint64> allocations{0};
+
+void countAllocation()
+{
+    if (counting)
+        ++allocations;
+}
+
+} // namespace
+
+#ifdef __GLIBC__
+// Qt's containers call malloc() directly, so operator new is not enough;
+// glibc lets the test replace malloc() for all libraries.
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+} // extern "C"
+#endif
+
+class TestAcquisitionTick : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestAcquisitionTick();
+    ~TestAcquisitionTick();
+
+private slots:
+    void initTestCase();
+    void testNoGuiThreadAllocations();
+
+private:
+    static const int WarmupTicks = 2000;
+    static const int Ticks = 5000;
+    static const int SamplesPerTick = 10;
+
+    /**
+     * @brief About 8000 samples of four channels, so the live buffers are
+     *        trimmed every few thousand samples, during the warm-up as well
+     *        as during the measurement.
+     */
+    static const qint64 MemoryBudget = 512 * 1024;
+
+    static bool write(int fd, const QByteArray &data);
+    static bool readUntil(SerialReader &reader, qint64 samples);
+};
+
+TestAcquisitionTick::TestAcquisitionTick()
+{
+
+}
+
+TestAcquisitionTick::~TestAcquisitionTick()
+{
+
+}
+
+void TestAcquisitionTick::initTestCase()
+{
+#ifndef __GLIBC__
+    QSKIP("Allocations are only counted with glibc.");
+#endif
+}
+
+void TestAcquisitionTick::testNoGuiThreadAllocations()
+{
+    // Covers what the GUI thread does per tick: draining the queues,
+    // indexing, trimming and rendering. The acquisition thread allocates
+    // the raw chunks it hands over, and the chart allocates when it lays
+    // out its axes; neither is counted.
+
+    // A pseudo terminal stands in for the board.
+    auto master = posix_openpt(O_RDWR | O_NOCTTY);
+    QVERIFY(master >= 0);
+    QCOMPARE(grantpt(master), 0);
+    QCOMPARE(unlockpt(master), 0);
+    QString portName(ptsname(master));
+
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    // The axes are not added to the chart, so moving them costs nothing
+    // but the frames of the plot item.
+    QValueAxis axisX;
+    QValueAxis axisY;
+    QChart chart;
+    RasterPlotItem item(&chart, &axisX, &axisY);
+    SerialReader reader;
+    axisX.setRange(0, reader.samples());
+    reader.setAxisX(&axisX);
+    reader.setPlotItem(&item);
+    reader.setFollowing(true);
+    reader.setMemoryBudget(MemoryBudget);
+    qint64 bytes = 0;
+    connect(&reader, &SerialReader::newData, [&](const QByteArray &data) {
+        bytes += data.size();
+    });
+    QVERIFY(reader.open(portName, 115200));
+    QVERIFY(reader.setHistoryFile(directory.filePath("session.mpts")));
+
+    // Generated up front, so only the ticks are measured.
+    StreamGenerator generator;
+    auto header = "Arduino Ready\r\n" + generator.schema().header() + "\r\n";
+    QVector<QByteArray> ticks;
+    for (int i=0; i<WarmupTicks + Ticks; ++i)
+        ticks.append(generator.lines(SamplesPerTick));
+
+    // Warming up fixes the schema, writes the first history chunks and lets
+    // the scratch buffers grow to their working size, trimming included.
+    QVERIFY(write(master, header));
+    for (int i=0; i<WarmupTicks; ++i) {
+        QVERIFY(write(master, ticks[i]));
+        QVERIFY(readUntil(reader, qint64(i + 1) * SamplesPerTick));
+    }
+
+    allocations = 0;
+    for (int i=WarmupTicks; i<ticks.size(); ++i) {
+        QVERIFY(write(master, ticks[i]));
+        QVERIFY(readUntil(reader, qint64(i + 1) * SamplesPerTick));
+    }
+
+    QCOMPARE(allocations.load(), qint64(0));
+    QCOMPARE(reader.sampleCount(), qint64(ticks.size()) * SamplesPerTick);
+    QVERIFY(reader.liveSampleCount() < Ticks * SamplesPerTick);
+    QCOMPARE(reader.invalidLines(), quint64(0));
+    QCOMPARE(reader.droppedSamples(), quint64(0));
+    QCOMPARE(reader.droppedChunks(), quint64(0));
+    QVERIFY(bytes > 0);
+
+    reader.close();
+    ::close(master);
+}
+
+bool TestAcquisitionTick::write(int fd, const QByteArray &data)
+{
+    auto p = data.constData();
+    auto end = p + data.size();
+    while (p < end) {
+        auto written = ::write(fd, p, static_cast<size_t>(end - p));
+        if (written < 0)
+            return false;
+        p += written;
+    }
+    return true;
+}
+
+bool TestAcquisitionTick::readUntil(SerialReader &reader, qint64 samples)
+{
+    // Every read() is a tick of the acquisition timer, whether it finds
+    // samples or not. The frames are rendered in between by the events,
+    // like in the application.
+    QElapsedTimer timeout;
+    timeout.start();
+    forever {
+        counting = true;
+        reader.read();
+        QCoreApplication::processEvents();
+        counting = false;
+        if (reader.sampleCount() >= samples)
+            return true;
+        if (timeout.elapsed() > 5000)
+            return false;
+        QThread::usleep(200);
+    }
+}
+
+QTEST_MAIN(TestAcquisitionTick)
+
+#include "testacquisitiontick.moc"
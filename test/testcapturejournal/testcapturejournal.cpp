@@ -0,0 +1,161 @@
+#include <QtTest>
+
+#include "../../src/capturejournal.h"
+
+class TestCaptureJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestCaptureJournal();
+    ~TestCaptureJournal();
+
+private slots:
+    void testWrite_data();
+    void testWrite();
+    void testWithoutHeader();
+    void testBacklog();
+    void testFlush();
+    void testOpenFails();
+    void testWriteFails();
+};
+
+TestCaptureJournal::TestCaptureJournal()
+{
+
+}
+
+TestCaptureJournal::~TestCaptureJournal()
+{
+
+}
+
+void TestCaptureJournal::testWrite_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::addRow("empty") << 0;
+    QTest::addRow("single chunk") << 1;
+    QTest::addRow("several batches") << 20000;
+}
+
+void TestCaptureJournal::testWrite()
+{
+    QFETCH(int, count);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("journal.csv");
+
+    CaptureJournal journal;
+    QVERIFY(journal.open(fileName, "ms,sync,air1,air2,air3,pulse"));
+    QVERIFY(journal.isOpen());
+    QCOMPARE(journal.fileName(), fileName);
+
+    QByteArray expected("ms,sync,air1,air2,air3,pulse");
+    for (int i=0; i<count; ++i) {
+        auto chunk = QByteArray::number(i * 5) + ",0,512,300,301,0";
+        journal.append(chunk);
+        expected.append('\n').append(chunk);
+        // Give the writer a chance to keep up with the small queue.
+        if (i % 1000 == 999)
+            QThread::msleep(50);
+    }
+    journal.close();
+    QVERIFY(!journal.isOpen());
+    QCOMPARE(journal.droppedChunks(), quint64(0));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void TestCaptureJournal::testWithoutHeader()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("journal.csv");
+
+    // The data brings its own header; nothing precedes the first chunk.
+    CaptureJournal journal;
+    QVERIFY(journal.open(fileName));
+    journal.append("ms,sync,a,b");
+    journal.append("1,0,2,3");
+    journal.close();
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QCOMPARE(file.readAll(), QByteArray("ms,sync,a,b\n1,0,2,3"));
+}
+
+void TestCaptureJournal::testBacklog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("journal.csv");
+
+    // Far more chunks than the queue holds, without giving the writer time;
+    // the ones held back are written in order.
+    CaptureJournal journal;
+    QVERIFY(journal.open(fileName, "ms,sync,a,b"));
+    QByteArray expected("ms,sync,a,b");
+    for (int i=0; i<50000; ++i) {
+        auto chunk = QByteArray::number(i) + ",0,1,2";
+        journal.append(chunk);
+        expected.append('\n').append(chunk);
+    }
+    journal.close();
+    QCOMPARE(journal.droppedChunks(), quint64(0));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
+void TestCaptureJournal::testFlush()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("journal.csv");
+
+    CaptureJournal journal;
+    QVERIFY(journal.open(fileName, "header"));
+    journal.append("1,0,1,1,1,1");
+
+    // Data reaches the file while the journal is still open.
+    QTRY_COMPARE_WITH_TIMEOUT(QFileInfo(fileName).size(), qint64(18), 5000);
+    journal.close();
+}
+
+void TestCaptureJournal::testOpenFails()
+{
+    CaptureJournal journal;
+    QVERIFY(!journal.open("does/not/exist/journal.csv", "header"));
+    QVERIFY(!journal.isOpen());
+    QVERIFY(!journal.errorString().isEmpty());
+
+    // Appending to a closed journal is a no-op.
+    journal.append("1,0,1,1,1,1");
+    QCOMPARE(journal.droppedChunks(), quint64(0));
+}
+
+void TestCaptureJournal::testWriteFails()
+{
+    if (!QFile::exists("/dev/full"))
+        QSKIP("Needs /dev/full.");
+
+    // Every write fails with a full disk. Far more chunks than the queue
+    // holds must not keep close() waiting for a writer that gave up.
+    CaptureJournal journal;
+    QVERIFY(journal.open("/dev/full", "header"));
+    for (int i=0; i<50000; ++i)
+        journal.append(QByteArray::number(i) + ",0,1,2");
+    journal.close();
+    QVERIFY(!journal.isOpen());
+    QVERIFY(journal.hasFailed());
+    QVERIFY(!journal.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestCaptureJournal)
+
+#include "testcapturejournal.moc"
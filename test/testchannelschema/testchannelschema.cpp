@@ -0,0 +1,97 @@
+#include <QtTest>
+
+#include "../../src/channelschema.h"
+#include "../../src/sample.h"
+
+class TestChannelSchema : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestChannelSchema();
+    ~TestChannelSchema();
+
+private slots:
+    void testDefault();
+    void testFromHeader_data();
+    void testFromHeader();
+    void testInvalid_data();
+    void testInvalid();
+};
+
+TestChannelSchema::TestChannelSchema()
+{
+
+}
+
+TestChannelSchema::~TestChannelSchema()
+{
+
+}
+
+void TestChannelSchema::testDefault()
+{
+    ChannelSchema schema;
+    QCOMPARE(schema.count(), 4);
+    QCOMPARE(schema.indexOf("pulse"), 3);
+    QCOMPARE(schema.header(), QByteArray("ms,sync,air1,air2,air3,pulse"));
+}
+
+void TestChannelSchema::testFromHeader_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QStringList>("names");
+
+    QTest::addRow("default") << QByteArray("ms,sync,air1,air2,air3,pulse")
+                             << QStringList({ "air1", "air2", "air3", "pulse" });
+    QTest::addRow("crlf") << QByteArray("ms,sync,a,b\r") << QStringList({ "a", "b" });
+    QTest::addRow("spaces") << QByteArray(" ms , sync , a ") << QStringList({ "a" });
+    QTest::addRow("eight") << QByteArray("ms,sync,c1,c2,c3,c4,c5,c6,c7,c8")
+                           << QStringList({ "c1", "c2", "c3", "c4", "c5", "c6", "c7", "c8" });
+}
+
+void TestChannelSchema::testFromHeader()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QStringList, names);
+
+    ChannelSchema schema;
+    QVERIFY(ChannelSchema::fromHeader(line.constData(), line.constData() + line.size(), schema));
+    QCOMPARE(schema.names(), names);
+
+    // The header written is read again as the same schema.
+    auto header = schema.header();
+    ChannelSchema again(QStringList{ "other" });
+    QVERIFY(ChannelSchema::fromHeader(header.constData(), header.constData() + header.size(), again));
+    QCOMPARE(again, schema);
+}
+
+void TestChannelSchema::testInvalid_data()
+{
+    QTest::addColumn<QByteArray>("line");
+
+    QByteArray tooMany("ms,sync");
+    for (int i=0; i<=Sample::MaxChannels; ++i)
+        tooMany.append(",c").append(QByteArray::number(i));
+
+    QTest::addRow("empty") << QByteArray();
+    QTest::addRow("sample") << QByteArray("1,0,512,513,514,515");
+    QTest::addRow("no channels") << QByteArray("ms,sync");
+    QTest::addRow("no sync") << QByteArray("ms,air1,air2");
+    QTest::addRow("empty name") << QByteArray("ms,sync,air1,,pulse");
+    QTest::addRow("too many") << tooMany;
+    QTest::addRow("ready") << QByteArray("Arduino Ready");
+}
+
+void TestChannelSchema::testInvalid()
+{
+    QFETCH(QByteArray, line);
+
+    ChannelSchema schema;
+    QVERIFY(!ChannelSchema::fromHeader(line.constData(), line.constData() + line.size(), schema));
+    QCOMPARE(schema, ChannelSchema());
+}
+
+QTEST_APPLESS_MAIN(TestChannelSchema)
+
+#include "testchannelschema.moc"
@@ -0,0 +1,15 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/sample.h
+
+SOURCES +=  \
+    testchannelschema.cpp  \
+    ../../src/channelschema.cpp
@@ -0,0 +1,241 @@
+#include <QtTest>
+
+#include "../../src/csvparser.h"
+
+#include <cstring>
+
+class TestCsvParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestCsvParser();
+    ~TestCsvParser();
+
+private slots:
+    void testParse_data();
+    void testParse();
+    void testChannels_data();
+    void testChannels();
+    void testInvalid_data();
+    void testInvalid();
+    void testToDouble_data();
+    void testToDouble();
+    void testForEachLine();
+    void benchmarkLive_data();
+    void benchmarkLive();
+    void benchmarkLoad();
+
+private:
+    static QByteArray lines(int count);
+};
+
+TestCsvParser::TestCsvParser()
+{
+
+}
+
+TestCsvParser::~TestCsvParser()
+{
+
+}
+
+void TestCsvParser::testParse_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<qreal>("ms");
+    QTest::addColumn<int>("sync");
+    QTest::addColumn<int>("air1");
+    QTest::addColumn<int>("air2");
+    QTest::addColumn<int>("air3");
+    QTest::addColumn<int>("pulse");
+
+    QTest::addRow("plain") << QByteArray("1234,0,512,513,514,515") << 1234.0 << 0 << 512 << 513 << 514 << 515;
+    QTest::addRow("crlf") << QByteArray("5,1,2,3,4,6\r") << 5.0 << 1 << 2 << 3 << 4 << 6;
+    QTest::addRow("spaces") << QByteArray(" 5 , 1,2 ,3,4,6") << 5.0 << 1 << 2 << 3 << 4 << 6;
+    QTest::addRow("fraction") << QByteArray("12.5,0,1,2,3,4") << 12.5 << 0 << 1 << 2 << 3 << 4;
+    QTest::addRow("signs") << QByteArray("-0.25,+1,-2,3,4,5") << -0.25 << 1 << -2 << 3 << 4 << 5;
+    QTest::addRow("limits") << QByteArray("0,0,-2147483648,2147483647,0,0") << 0.0 << 0 << INT_MIN << INT_MAX << 0 << 0;
+}
+
+void TestCsvParser::testParse()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(qreal, ms);
+    QFETCH(int, sync);
+    QFETCH(int, air1);
+    QFETCH(int, air2);
+    QFETCH(int, air3);
+    QFETCH(int, pulse);
+
+    Sample sample;
+    QVERIFY(CsvParser::parse(line.constData(), line.constData() + line.size(), 4, sample));
+    QCOMPARE(sample.ms, ms);
+    QCOMPARE(sample.sync, sync);
+    QCOMPARE(sample.values[0], air1);
+    QCOMPARE(sample.values[1], air2);
+    QCOMPARE(sample.values[2], air3);
+    QCOMPARE(sample.values[3], pulse);
+}
+
+void TestCsvParser::testChannels_data()
+{
+    QTest::addColumn<int>("channels");
+
+    QTest::addRow("1") << 1;
+    QTest::addRow("8") << 8;
+    QTest::addRow("16") << int(Sample::MaxChannels);
+}
+
+void TestCsvParser::testChannels()
+{
+    QFETCH(int, channels);
+
+    QByteArray line("10,1");
+    for (int i=0; i<channels; ++i)
+        line.append(',').append(QByteArray::number(100 + i));
+
+    Sample sample;
+    auto end = line.constData() + line.size();
+    QVERIFY(CsvParser::parse(line.constData(), end, channels, sample));
+    QCOMPARE(sample.ms, 10.0);
+    QCOMPARE(sample.sync, 1);
+    for (int i=0; i<channels; ++i)
+        QCOMPARE(sample.values[i], 100 + i);
+
+    // The row must have exactly the channels of the schema.
+    if (channels > 1)
+        QVERIFY(!CsvParser::parse(line.constData(), end, channels - 1, sample));
+    if (channels < Sample::MaxChannels)
+        QVERIFY(!CsvParser::parse(line.constData(), end, channels + 1, sample));
+}
+
+void TestCsvParser::testInvalid_data()
+{
+    QTest::addColumn<QByteArray>("line");
+
+    QTest::addRow("empty") << QByteArray();
+    QTest::addRow("header") << QByteArray("ms,sync,air1,air2,air3,pulse");
+    QTest::addRow("too few") << QByteArray("1,2,3,4,5");
+    QTest::addRow("too many") << QByteArray("1,2,3,4,5,6,7");
+    QTest::addRow("empty field") << QByteArray("1,,3,4,5,6");
+    QTest::addRow("overflow") << QByteArray("1,2,3,4,5,2147483648");
+    QTest::addRow("garbage") << QByteArray("1,2,3,4,5,6x");
+}
+
+void TestCsvParser::testInvalid()
+{
+    QFETCH(QByteArray, line);
+
+    Sample sample;
+    sample.values[0] = 42;
+    QVERIFY(!CsvParser::parse(line.constData(), line.constData() + line.size(), 4, sample));
+    QCOMPARE(sample.values[0], 42);
+}
+
+void TestCsvParser::testToDouble_data()
+{
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::addRow("integer") << QByteArray("123456");
+    QTest::addRow("tenth") << QByteArray("0.1");
+    QTest::addRow("leading zeros") << QByteArray("0.000123");
+    QTest::addRow("negative") << QByteArray("-98765.4321");
+    QTest::addRow("exponent") << QByteArray("1.5e-3");
+    QTest::addRow("long") << QByteArray("3.14159265358979");
+}
+
+void TestCsvParser::testToDouble()
+{
+    QFETCH(QByteArray, text);
+
+    qreal value;
+    auto end = CsvParser::toDouble(text.constData(), text.constData() + text.size(), value);
+    QCOMPARE(end, text.constData() + text.size());
+    QCOMPARE(value, text.toDouble());
+}
+
+void TestCsvParser::testForEachLine()
+{
+    QByteArray data("1,0,1,1,1,1\n\n2,0,2,2,2,2\r\n3,0,3");
+    QVector<int> air1;
+    Sample sample;
+    auto rest = CsvParser::forEachLine(data.constData(), data.constData() + data.size(),
+                                       [&](const char *begin, const char *end) {
+        if (CsvParser::parse(begin, end, 4, sample))
+            air1.append(sample.values[0]);
+    });
+
+    QCOMPARE(air1, QVector<int>({ 1, 2 }));
+    QCOMPARE(QByteArray(rest), QByteArray("3,0,3"));
+}
+
+void TestCsvParser::benchmarkLive_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    // Roughly what a single readyRead() delivers at low and high baud rates.
+    QTest::addRow("64 bytes") << 64;
+    QTest::addRow("4 KiB") << 4096;
+}
+
+void TestCsvParser::benchmarkLive()
+{
+    QFETCH(int, chunkSize);
+
+    // Same buffer handling as SerialWorker::read(); the lines per second are
+    // 100000 divided by the reported time.
+    auto data = lines(100000);
+    QByteArray buffer;
+    buffer.reserve(2 * chunkSize);
+    Sample sample;
+    int count = 0;
+    QBENCHMARK {
+        for (int offset=0; offset<data.size(); offset+=chunkSize) {
+            buffer.append(data.constData() + offset, qMin(chunkSize, data.size() - offset));
+            auto begin = buffer.constData();
+            auto rest = CsvParser::forEachLine(begin, begin + buffer.size(),
+                                               [&](const char *lineBegin, const char *lineEnd) {
+                if (CsvParser::parse(lineBegin, lineEnd, 4, sample))
+                    ++count;
+            });
+            buffer.remove(0, static_cast<int>(rest - begin));
+        }
+    }
+    QVERIFY(count > 0);
+}
+
+void TestCsvParser::benchmarkLoad()
+{
+    // Same as SerialReader::load(); the lines per second are 100000 divided
+    // by the reported time.
+    auto data = lines(100000);
+    Sample sample;
+    int count = 0;
+    QBENCHMARK {
+        count = 0;
+        CsvParser::forEachLine(data.constData(), data.constData() + data.size(),
+                               [&](const char *begin, const char *end) {
+            if (CsvParser::parse(begin, end, 4, sample))
+                ++count;
+        });
+    }
+    QCOMPARE(count, 100000);
+}
+
+QByteArray TestCsvParser::lines(int count)
+{
+    QByteArray data;
+    for (int i=0; i<count; ++i) {
+        data.append(QByteArray::number(i * 5)).append(",0,");
+        data.append(QByteArray::number(300 + (i * 7919) % 41)).append(',');
+        data.append(QByteArray::number(310 + (i * 104729) % 37)).append(',');
+        data.append(QByteArray::number(320 + (i * 1299709) % 31)).append(',');
+        data.append(QByteArray::number(500 + i % 100)).append("\r\n");
+    }
+    return data;
+}
+
+QTEST_APPLESS_MAIN(TestCsvParser)
+
+#include "testcsvparser.moc"
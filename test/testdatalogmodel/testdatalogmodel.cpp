@@ -0,0 +1,155 @@
+#include <QtTest>
+
+#include "../../src/datalogmodel.h"
+
+class TestDataLogModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDataLogModel();
+    ~TestDataLogModel();
+
+private slots:
+    void testRawData_data();
+    void testRawData();
+    void testAppend();
+    void testTail();
+    void testMaximumSize();
+
+private:
+    static QByteArray file();
+    static QList<QByteArray> lines(const QByteArray &data);
+};
+
+TestDataLogModel::TestDataLogModel()
+{
+
+}
+
+TestDataLogModel::~TestDataLogModel()
+{
+
+}
+
+void TestDataLogModel::testRawData_data()
+{
+    QTest::addColumn<int>("step");
+
+    QTest::addRow("at once") << 0;
+    QTest::addRow("byte by byte") << 1;
+    QTest::addRow("odd chunks") << 37;
+}
+
+void TestDataLogModel::testRawData()
+{
+    QFETCH(int, step);
+
+    auto data = file();
+    DataLogModel model;
+    QSignalSpy inserted(&model, &DataLogModel::rowsInserted);
+    model.setRawData(data, 0);
+    if (step > 0) {
+        for (int available=0; available<data.size(); available+=step)
+            model.setAvailable(available);
+    }
+    model.setAvailable(data.size());
+
+    auto expected = lines(data);
+    QCOMPARE(model.rowCount(), expected.size());
+    int rows = 0;
+    for (auto &arguments: inserted)
+        rows += arguments[2].toInt() - arguments[1].toInt() + 1;
+    QCOMPARE(rows, expected.size());
+    for (int i=0; i<expected.size(); ++i)
+        QCOMPARE(model.line(i), expected[i]);
+    QCOMPARE(model.data(model.index(1)).toString(), QString("0,0,512,300,301,0"));
+}
+
+void TestDataLogModel::testAppend()
+{
+    DataLogModel model;
+    QByteArray expected;
+    for (int i=0; i<300; ++i) {
+        auto chunk = QByteArray::number(i) + ",0,1,2,3,4\r\n" + QByteArray::number(i) + ",1,1,2,3,4";
+        model.append(chunk);
+        expected.append('\n').append(chunk);
+    }
+
+    QCOMPARE(model.rawData(), expected);
+    auto rows = lines(expected);
+    QCOMPARE(model.rowCount(), rows.size());
+    for (int i=0; i<rows.size(); ++i)
+        QCOMPARE(model.line(i), rows[i]);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void TestDataLogModel::testTail()
+{
+    QByteArray data("1,0,1,1,1,1\n2,0,2");
+    DataLogModel model;
+    model.setRawData(data + ",2,2,2\n3", 0);
+    model.setAvailable(data.size());
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.line(1), QByteArray("2,0,2"));
+
+    // The unterminated last row is continued, not inserted again.
+    int changed = 0;
+    connect(&model, &DataLogModel::dataChanged, [&] { ++changed; });
+    model.setAvailable(data.size() + 9);
+    QCOMPARE(changed, 1);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.line(1), QByteArray("2,0,2,2,2,2"));
+    QCOMPARE(model.line(2), QByteArray("3"));
+}
+
+void TestDataLogModel::testMaximumSize()
+{
+    const int maximumSize = 4096;
+    DataLogModel model;
+    model.setMaximumSize(maximumSize);
+    QByteArray all;
+    for (int i=0; i<2000; ++i) {
+        auto chunk = QByteArray::number(i) + ",0,512,300,301,0";
+        model.append(chunk);
+        all.append('\n').append(chunk);
+        QVERIFY(model.rawData().size() <= maximumSize);
+    }
+
+    // Whatever is kept is the latest part, line by line.
+    QVERIFY(all.endsWith(model.rawData()));
+    auto rows = lines(model.rawData());
+    QCOMPARE(model.rowCount(), rows.size());
+    for (int i=0; i<rows.size(); ++i)
+        QCOMPARE(model.line(i), rows[i]);
+    QCOMPARE(model.line(rows.size()-1), QByteArray("1999,0,512,300,301,0"));
+}
+
+QByteArray TestDataLogModel::file()
+{
+    QByteArray data("ms,sync,air1,air2,air3,pulse\r\n");
+    for (int i=0; i<1000; ++i) {
+        data.append(QByteArray::number(i * 5)).append(",0,512,300,301,0\r\n");
+        if (i % 97 == 0)
+            data.append("\r\n\n");
+    }
+    return data;
+}
+
+QList<QByteArray> TestDataLogModel::lines(const QByteArray &data)
+{
+    QList<QByteArray> result;
+    for (auto line: data.split('\n')) {
+        if (line.endsWith('\r'))
+            line.chop(1);
+        if (!line.isEmpty())
+            result.append(line);
+    }
+    return result;
+}
+
+QTEST_APPLESS_MAIN(TestDataLogModel)
+
+#include "testdatalogmodel.moc"
@@ -0,0 +1,14 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/datalogmodel.h
+
+SOURCES +=  \
+    testdatalogmodel.cpp  \
+    ../../src/datalogmodel.cpp
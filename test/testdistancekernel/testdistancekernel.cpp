@@ -0,0 +1,146 @@
+#include <QtTest>
+
+#include "../../src/channelview.h"
+#include "../../src/distancekernel.h"
+
+Q_DECLARE_METATYPE(DistanceKernel::InstructionSet)
+
+class TestDistanceKernel : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestDistanceKernel();
+    ~TestDistanceKernel();
+
+private slots:
+    void testFarthest_data();
+    void testFarthest();
+    void testInstructionSets();
+    void benchmarkFarthest_data();
+    void benchmarkFarthest();
+
+private:
+    static ChannelBuffer samples(int count);
+};
+
+TestDistanceKernel::TestDistanceKernel()
+{
+
+}
+
+TestDistanceKernel::~TestDistanceKernel()
+{
+
+}
+
+void TestDistanceKernel::testFarthest_data()
+{
+    QTest::addColumn<QVector<QPointF>>("input");
+    QTest::addColumn<QPointF>("start");
+    QTest::addColumn<QPointF>("end");
+    QTest::addColumn<int>("index");
+    QTest::addColumn<qreal>("squaredDistance");
+
+    QTest::addRow("empty") << QVector<QPointF>() << QPointF(0,0) << QPointF(1,0)
+                           << -1 << 0.0;
+
+    QTest::addRow("one") << QVector<QPointF>{ QPointF(1,2) } << QPointF(0,0) << QPointF(4,0)
+                         << 0 << 4.0;
+
+    QTest::addRow("on line") << QVector<QPointF>{ QPointF(1,1), QPointF(2,2) }
+                             << QPointF(0,0) << QPointF(3,3)
+                             << 0 << 0.0;
+
+    QTest::addRow("tie") << QVector<QPointF>{ QPointF(1,1), QPointF(2,-3), QPointF(3,3),
+                                              QPointF(4,0), QPointF(5,-3) }
+                         << QPointF(0,0) << QPointF(6,0)
+                         << 1 << 9.0;
+
+    QTest::addRow("degenerated") << QVector<QPointF>{ QPointF(1,0), QPointF(0,2), QPointF(1,1) }
+                                 << QPointF(0,0) << QPointF(0,0)
+                                 << 1 << 4.0;
+}
+
+void TestDistanceKernel::testFarthest()
+{
+    QFETCH(QVector<QPointF>, input);
+    QFETCH(QPointF, start);
+    QFETCH(QPointF, end);
+    QFETCH(int, index);
+    QFETCH(qreal, squaredDistance);
+
+    ChannelBuffer columns(input);
+    auto view = columns.view();
+    qreal distance;
+    QCOMPARE(DistanceKernel::farthest(view.x(), view.y(), view.size(), start, end, distance),
+             index);
+    QCOMPARE(distance, squaredDistance);
+}
+
+void TestDistanceKernel::testInstructionSets()
+{
+    auto columns = samples(1000);
+    auto data = columns.view();
+    QVector<DistanceKernel::InstructionSet> instructionSets{
+        DistanceKernel::InstructionSet::Sse2,
+        DistanceKernel::InstructionSet::Avx2
+    };
+
+    // Every length exercises another remainder of the vector loops.
+    for (int count=0; count<40; ++count) {
+        for (int offset=0; offset<data.size()-count; offset+=97) {
+            auto x = data.x() + offset;
+            auto y = data.y() + offset;
+            QPointF start(offset - 1, 300.0);
+            QPointF end(offset + count, 310.0);
+            qreal expected;
+            auto index = DistanceKernel::farthest(x, y, count, start, end, expected,
+                                                  DistanceKernel::InstructionSet::Scalar);
+            for (auto instructionSet: instructionSets) {
+                qreal actual;
+                QCOMPARE(DistanceKernel::farthest(x, y, count, start, end, actual,
+                                                  instructionSet), index);
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+}
+
+void TestDistanceKernel::benchmarkFarthest_data()
+{
+    QTest::addColumn<DistanceKernel::InstructionSet>("instructionSet");
+
+    QTest::addRow("scalar") << DistanceKernel::InstructionSet::Scalar;
+    QTest::addRow("sse2") << DistanceKernel::InstructionSet::Sse2;
+    QTest::addRow("avx2") << DistanceKernel::InstructionSet::Avx2;
+}
+
+void TestDistanceKernel::benchmarkFarthest()
+{
+    QFETCH(DistanceKernel::InstructionSet, instructionSet);
+
+    if (instructionSet > DistanceKernel::supported())
+        QSKIP("Instruction set not supported by this CPU.");
+
+    auto columns = samples(4096);
+    auto data = columns.view();
+    qreal distance;
+    QBENCHMARK {
+        DistanceKernel::farthest(data.x(), data.y(), data.size(),
+                                 data.first(), data.last(), distance, instructionSet);
+    }
+}
+
+ChannelBuffer TestDistanceKernel::samples(int count)
+{
+    ChannelBuffer data;
+    data.reserve(count);
+    for (int i=0; i<count; ++i)
+        data.append(i, 300 + (i * 7919) % 41 - 20);
+    return data;
+}
+
+QTEST_APPLESS_MAIN(TestDistanceKernel)
+
+#include "testdistancekernel.moc"
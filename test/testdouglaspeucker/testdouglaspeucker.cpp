@@ -13,6 +13,10 @@ public:
 private slots:
     void testDouglasPeucker_data();
     void testDouglasPeucker();
+    void testDouglasPeuckerRange();
+    void testSignificance_data();
+    void testSignificance();
+    void testParallel();
 };
 
 TestDouglasPeucker::TestDouglasPeucker()
@@ -68,10 +72,78 @@ void TestDouglasPeucker::testDouglasPeucker()
     QFETCH(QVector<QPointF>, result);
 
     QVector<QPointF> output;
-    DouglasPeucker::douglasPeucker(input, 0.5, output);
+    DouglasPeucker::douglasPeucker(ChannelBuffer(input), 0.5, output);
     QCOMPARE(output, result);
 }
 
+void TestDouglasPeucker::testDouglasPeuckerRange()
+{
+    ChannelBuffer input(QVector<QPointF>{ QPointF(0.0, 5.0), QPointF(1.0, 5.0),
+                                          QPointF(2.0, 1.0), QPointF(3.0, 2.0),
+                                          QPointF(4.0, 3.0), QPointF(5.0, 2.0),
+                                          QPointF(6.0, 1.0), QPointF(7.0, 0.0),
+                                          QPointF(8.0, 9.0) });
+
+    QVector<int> indices;
+    QVector<DouglasPeucker::Range> stack;
+    DouglasPeucker::douglasPeucker(input, 2, 7, 0.5, indices, stack);
+    QCOMPARE(indices, (QVector<int>{ 2, 4, 7 }));
+    QVERIFY(stack.isEmpty());
+
+    DouglasPeucker::douglasPeucker(input, 3, 3, 0.5, indices, stack);
+    QCOMPARE(indices, QVector<int>{ 3 });
+
+    DouglasPeucker::douglasPeucker(input, 4, 3, 0.5, indices, stack);
+    QVERIFY(indices.isEmpty());
+}
+
+void TestDouglasPeucker::testSignificance_data()
+{
+    testDouglasPeucker_data();
+}
+
+void TestDouglasPeucker::testSignificance()
+{
+    QFETCH(QVector<QPointF>, input);
+    QFETCH(QVector<QPointF>, result);
+
+    QVector<qreal> significance(input.size());
+    QVector<DouglasPeucker::Range> stack;
+    DouglasPeucker::significance(ChannelBuffer(input), 0, input.size()-1,
+                                 significance, stack);
+
+    QVector<QPointF> output;
+    for (int i=0; i<input.size(); ++i) {
+        if (significance[i] > 0.5 * 0.5)
+            output.append(input[i]);
+    }
+    QCOMPARE(output, result);
+}
+
+void TestDouglasPeucker::testParallel()
+{
+    // Large enough to be split into concurrent subtrees.
+    ChannelBuffer input;
+    for (int i=0; i<200000; ++i) {
+        auto y = 300.0 + 40.0 * qSin(i / 50.0) + (i * 7919 % 13) * 0.5;
+        input.append(i * 10.0, y);
+    }
+    auto last = input.size() - 1;
+
+    QVector<int> serial;
+    QVector<int> parallel;
+    QVector<DouglasPeucker::Range> stack;
+    DouglasPeucker::douglasPeucker(input, 0, last, 2.0, serial, stack);
+    DouglasPeucker::parallelDouglasPeucker(input, 0, last, 2.0, parallel);
+    QCOMPARE(parallel, serial);
+
+    QVector<qreal> serialSignificance(input.size());
+    QVector<qreal> parallelSignificance(input.size());
+    DouglasPeucker::significance(input, 0, last, serialSignificance, stack);
+    DouglasPeucker::parallelSignificance(input, 0, last, parallelSignificance);
+    QCOMPARE(parallelSignificance, serialSignificance);
+}
+
 QTEST_APPLESS_MAIN(TestDouglasPeucker)
 
 #include "testdouglaspeucker.moc"
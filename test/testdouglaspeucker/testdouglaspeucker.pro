@@ -1,4 +1,4 @@
-QT += testlib
+QT += testlib concurrent
 QT -= gui
 
 CONFIG += qt console warn_on depend_includepath testcase
@@ -7,8 +7,11 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 HEADERS +=  \
+    ../../src/channelview.h \
+    ../../src/distancekernel.h \
     ../../src/douglaspeuker.h
 
 SOURCES +=  \
     testdouglaspeucker.cpp  \
+    ../../src/distancekernel.cpp \
     ../../src/douglaspeucker.cpp
@@ -0,0 +1,106 @@
+#include <QtTest>
+
+#include "../../src/latencyhistogram.h"
+
+class TestLatencyHistogram : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestLatencyHistogram();
+    ~TestLatencyHistogram();
+
+private slots:
+    void testPercentiles();
+    void testWeights();
+    void testOverflow();
+    void testSave();
+    void testNow();
+
+};
+
+TestLatencyHistogram::TestLatencyHistogram()
+{
+
+}
+
+TestLatencyHistogram::~TestLatencyHistogram()
+{
+
+}
+
+void TestLatencyHistogram::testPercentiles()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.percentile(0.5), 0.0);
+
+    for (int i=1; i<=100; ++i)
+        histogram.add(i * 1000000LL);
+    QCOMPARE(histogram.count(), qint64(100));
+    QCOMPARE(histogram.mean(), 50.5);
+    QCOMPARE(histogram.max(), 100.0);
+
+    // The upper edge of the bucket, but never more than the maximum.
+    QCOMPARE(histogram.percentile(0.5), 50.5);
+    QCOMPARE(histogram.percentile(0.99), 99.5);
+    QCOMPARE(histogram.percentile(1.0), 100.0);
+
+    histogram.clear();
+    QCOMPARE(histogram.count(), qint64(0));
+    QCOMPARE(histogram.max(), 0.0);
+}
+
+void TestLatencyHistogram::testWeights()
+{
+    LatencyHistogram histogram;
+    histogram.add(10000000LL, 99);
+    histogram.add(500000000LL);
+    histogram.add(1000000LL, 0);
+
+    QCOMPARE(histogram.count(), qint64(100));
+    QCOMPARE(histogram.percentile(0.5), 10.5);
+    QCOMPARE(histogram.percentile(0.99), 10.5);
+    QCOMPARE(histogram.percentile(0.999), 500.0);
+}
+
+void TestLatencyHistogram::testOverflow()
+{
+    // Longer than the range, but still the maximum.
+    LatencyHistogram histogram;
+    histogram.add(5000000000LL);
+    histogram.add(-1000000LL);
+
+    QCOMPARE(histogram.count(), qint64(2));
+    QCOMPARE(histogram.percentile(0.5), 0.5);
+    QCOMPARE(histogram.percentile(1.0), 5000.0);
+}
+
+void TestLatencyHistogram::testSave()
+{
+    LatencyHistogram histogram;
+    histogram.add(1200000LL, 3);
+    histogram.add(2000000000LL);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(histogram.save(file.fileName()));
+
+    auto lines = file.readAll().split('\n');
+    QCOMPARE(lines.size(), 4);
+    QCOMPARE(lines[0], QByteArray("fromMs,toMs,samples"));
+    QCOMPARE(lines[1], QByteArray("1,1.5,3"));
+    QCOMPARE(lines[2], QByteArray("1000,inf,1"));
+}
+
+void TestLatencyHistogram::testNow()
+{
+    auto start = LatencyHistogram::now();
+    QThread::msleep(10);
+    auto elapsed = LatencyHistogram::now() - start;
+    QVERIFY(elapsed >= 10000000LL);
+    QVERIFY(elapsed < 1000000000LL);
+}
+
+QTEST_GUILESS_MAIN(TestLatencyHistogram)
+
+#include "testlatencyhistogram.moc"
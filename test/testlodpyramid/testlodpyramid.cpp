@@ -0,0 +1,135 @@
+#include <QtTest>
+
+#include "../../src/lodpyramid.h"
+#include "../../src/minmaxdecimator.h"
+
+#include <algorithm>
+
+class TestLodPyramid : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestLodPyramid();
+    ~TestLodPyramid();
+
+private slots:
+    void testIncremental();
+    void testQuery_data();
+    void testQuery();
+    void testFineRange();
+
+private:
+    static ChannelBuffer samples(int count);
+};
+
+TestLodPyramid::TestLodPyramid()
+{
+
+}
+
+TestLodPyramid::~TestLodPyramid()
+{
+
+}
+
+void TestLodPyramid::testIncremental()
+{
+    auto columns = samples(50000);
+    auto data = columns.view();
+
+    LodPyramid batch;
+    batch.update(data);
+
+    LodPyramid incremental;
+    ChannelBuffer growing;
+    for (int i=0; i<data.size(); ++i) {
+        growing.append(data[i].x(), data[i].y());
+        if (i % 37 == 0)
+            incremental.update(growing);
+    }
+    incremental.update(growing);
+
+    QCOMPARE(incremental.levels(), batch.levels());
+    QVector<QPointF> expected;
+    QVector<QPointF> actual;
+    batch.query(data, 1000.0, 80000.0, 300, expected);
+    incremental.query(data, 1000.0, 80000.0, 300, actual);
+    QCOMPARE(actual, expected);
+}
+
+void TestLodPyramid::testQuery_data()
+{
+    QTest::addColumn<qreal>("minX");
+    QTest::addColumn<qreal>("maxX");
+    QTest::addColumn<int>("width");
+
+    QTest::addRow("all") << 0.0 << 200000.0 << 1920;
+    QTest::addRow("narrow") << 0.0 << 200000.0 << 100;
+    QTest::addRow("zoomed") << 50000.0 << 60000.0 << 800;
+    QTest::addRow("scrolled") << 150000.0 << 250000.0 << 800;
+}
+
+void TestLodPyramid::testQuery()
+{
+    QFETCH(qreal, minX);
+    QFETCH(qreal, maxX);
+    QFETCH(int, width);
+
+    auto columns = samples(100000);
+    auto data = columns.view();
+    LodPyramid pyramid;
+    pyramid.update(data);
+
+    QVector<QPointF> result;
+    pyramid.query(data, minX, maxX, width, result);
+    QVERIFY(!result.isEmpty());
+    QVERIFY(result.size() <= 4 * (width + 1));
+    for (int i=1; i<result.size(); ++i)
+        QVERIFY(result[i-1].x() < result[i].x());
+
+    // The extremes of the visible samples must survive.
+    qreal minY = std::numeric_limits<qreal>::max();
+    qreal maxY = std::numeric_limits<qreal>::lowest();
+    for (int i=0; i<data.size(); ++i) {
+        auto point = data[i];
+        if (point.x() < minX || point.x() > maxX)
+            continue;
+        minY = qMin(minY, point.y());
+        maxY = qMax(maxY, point.y());
+    }
+    auto found = [&](qreal y) {
+        return std::any_of(result.cbegin(), result.cend(),
+                           [y](const QPointF &point) { return point.y() == y; });
+    };
+    QVERIFY(found(minY));
+    QVERIFY(found(maxY));
+}
+
+void TestLodPyramid::testFineRange()
+{
+    auto data = samples(100000);
+    LodPyramid pyramid;
+    pyramid.update(data);
+
+    QVector<QPointF> expected;
+    QVector<QPointF> actual;
+    MinMaxDecimator::decimate(data, 1000.0, 2000.0, 800, expected);
+    pyramid.query(data, 1000.0, 2000.0, 800, actual);
+    QCOMPARE(actual, expected);
+}
+
+ChannelBuffer TestLodPyramid::samples(int count)
+{
+    ChannelBuffer data;
+    data.reserve(count);
+    for (int i=0; i<count; ++i) {
+        auto y = 300.0 + 40.0 * qSin(i / 200.0) + (i * 7919 % 31);
+        data.append(i * 2.0, y);
+    }
+    return data;
+}
+
+QTEST_APPLESS_MAIN(TestLodPyramid)
+
+#include "testlodpyramid.moc"
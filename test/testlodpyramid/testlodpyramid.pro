@@ -0,0 +1,17 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelview.h \
+    ../../src/lodpyramid.h \
+    ../../src/minmaxdecimator.h
+
+SOURCES +=  \
+    testlodpyramid.cpp  \
+    ../../src/lodpyramid.cpp \
+    ../../src/minmaxdecimator.cpp
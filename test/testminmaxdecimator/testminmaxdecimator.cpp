@@ -0,0 +1,90 @@
+#include <QtTest>
+
+#include "../../src/minmaxdecimator.h"
+
+class TestMinMaxDecimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestMinMaxDecimator();
+    ~TestMinMaxDecimator();
+
+private slots:
+    void testDecimate_data();
+    void testDecimate();
+    void testBound();
+};
+
+TestMinMaxDecimator::TestMinMaxDecimator()
+{
+
+}
+
+TestMinMaxDecimator::~TestMinMaxDecimator()
+{
+
+}
+
+void TestMinMaxDecimator::testDecimate_data()
+{
+    QTest::addColumn<QVector<QPointF>>("input");
+    QTest::addColumn<qreal>("minX");
+    QTest::addColumn<qreal>("maxX");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<QVector<QPointF>>("result");
+
+    QTest::addRow("empty") << QVector<QPointF>() << 0.0 << 10.0 << 10
+                           << QVector<QPointF>();
+
+    QTest::addRow("no width") << QVector<QPointF>{ QPointF(1,1) } << 0.0 << 10.0 << 0
+                              << QVector<QPointF>();
+
+    QTest::addRow("sparse") << QVector<QPointF>{ QPointF(1,1), QPointF(5,2), QPointF(9,3) }
+                            << 0.0 << 10.0 << 10
+                            << QVector<QPointF>{ QPointF(1,1), QPointF(5,2), QPointF(9,3) };
+
+    QTest::addRow("one column") << QVector<QPointF>{ QPointF(0,5), QPointF(1,9),
+                                                     QPointF(2,7), QPointF(3,1),
+                                                     QPointF(4,6), QPointF(5,4) }
+                                << 0.0 << 10.0 << 1
+                                << QVector<QPointF>{ QPointF(0,5), QPointF(1,9),
+                                                     QPointF(3,1), QPointF(5,4) };
+
+    QTest::addRow("outside") << QVector<QPointF>{ QPointF(0,1), QPointF(1,2),
+                                                  QPointF(5,3), QPointF(6,4),
+                                                  QPointF(10,5), QPointF(11,6) }
+                             << 4.0 << 8.0 << 4
+                             << QVector<QPointF>{ QPointF(1,2), QPointF(5,3),
+                                                  QPointF(6,4), QPointF(10,5) };
+}
+
+void TestMinMaxDecimator::testDecimate()
+{
+    QFETCH(QVector<QPointF>, input);
+    QFETCH(qreal, minX);
+    QFETCH(qreal, maxX);
+    QFETCH(int, width);
+    QFETCH(QVector<QPointF>, result);
+
+    QVector<QPointF> output;
+    MinMaxDecimator::decimate(ChannelBuffer(input), minX, maxX, width, output);
+    QCOMPARE(output, result);
+}
+
+void TestMinMaxDecimator::testBound()
+{
+    QVector<QPointF> input;
+    for (int i=0; i<100000; ++i)
+        input.append(QPointF(i, (i * 7919) % 1024));
+
+    QVector<QPointF> output;
+    MinMaxDecimator::decimate(ChannelBuffer(input), 0.0, input.last().x(), 640, output);
+    QVERIFY(output.size() <= 4 * (640 + 1));
+    QCOMPARE(output.first(), input.first());
+    QCOMPARE(output.last(), input.last());
+}
+
+QTEST_APPLESS_MAIN(TestMinMaxDecimator)
+
+#include "testminmaxdecimator.moc"
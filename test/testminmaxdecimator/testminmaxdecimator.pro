@@ -0,0 +1,15 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelview.h \
+    ../../src/minmaxdecimator.h
+
+SOURCES +=  \
+    testminmaxdecimator.cpp  \
+    ../../src/minmaxdecimator.cpp
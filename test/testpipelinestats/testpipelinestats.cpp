@@ -0,0 +1,129 @@
+#include <QtTest>
+
+#include "../../src/pipelinestats.h"
+
+class TestPipelineStats : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestPipelineStats();
+    ~TestPipelineStats();
+
+private slots:
+    void testPercentiles();
+    void testWindow();
+    void testTick();
+    void testDisabled();
+    void testSave();
+
+};
+
+TestPipelineStats::TestPipelineStats()
+{
+
+}
+
+TestPipelineStats::~TestPipelineStats()
+{
+
+}
+
+void TestPipelineStats::testPercentiles()
+{
+    // 1 to 100 ms in reverse order.
+    PipelineStats stats;
+    for (int i=100; i>0; --i)
+        stats.record(PipelineStats::Simplify, i * 1000000LL, 10 * i, i);
+
+    auto summary = stats.summary(PipelineStats::Simplify);
+    QCOMPARE(summary.ticks, 100);
+    QCOMPARE(summary.p50, 50.0);
+    QCOMPARE(summary.p99, 99.0);
+    QCOMPARE(summary.pointsIn, 505.0);
+    QCOMPARE(summary.pointsOut, 50.5);
+
+    QCOMPARE(stats.summary(PipelineStats::Update).ticks, 0);
+    QVERIFY(stats.toString().startsWith("simplify 50.00/99.00 ms 505"));
+}
+
+void TestPipelineStats::testWindow()
+{
+    // Only the last Window ticks count.
+    PipelineStats stats;
+    for (int i=0; i<PipelineStats::Window; ++i)
+        stats.record(PipelineStats::Read, 1000000000LL);
+    for (int i=0; i<PipelineStats::Window; ++i)
+        stats.record(PipelineStats::Read, 1000000LL);
+
+    auto summary = stats.summary(PipelineStats::Read);
+    QCOMPARE(summary.ticks, int(PipelineStats::Window));
+    QCOMPARE(summary.p99, 1.0);
+
+    stats.clear();
+    QCOMPARE(stats.summary(PipelineStats::Read).ticks, 0);
+    QVERIFY(stats.toString().isEmpty());
+}
+
+void TestPipelineStats::testTick()
+{
+    PipelineStats stats;
+    stats.setEnabled(true);
+    {
+        PipelineStats::Tick tick(&stats, PipelineStats::Update, false);
+        for (int i=0; i<3; ++i) {
+            tick.start();
+            QThread::msleep(5);
+            tick.stop();
+            tick.addPoints(2, 1);
+            QThread::msleep(20);
+        }
+    }
+    {
+        PipelineStats::Tick tick(&stats, PipelineStats::Update);
+        tick.discard();
+    }
+
+    // The pauses between the parts are not measured.
+    auto summary = stats.summary(PipelineStats::Update);
+    QCOMPARE(summary.ticks, 1);
+    QVERIFY(summary.p50 >= 15.0);
+    QVERIFY(summary.p50 < 60.0);
+    QCOMPARE(summary.pointsIn, 6.0);
+    QCOMPARE(summary.pointsOut, 3.0);
+}
+
+void TestPipelineStats::testDisabled()
+{
+    PipelineStats stats;
+    {
+        PipelineStats::Tick tick(&stats, PipelineStats::Paint);
+        stats.setEnabled(true);
+    }
+    {
+        PipelineStats::Tick tick(nullptr, PipelineStats::Paint);
+    }
+    QCOMPARE(stats.summary(PipelineStats::Paint).ticks, 0);
+}
+
+void TestPipelineStats::testSave()
+{
+    PipelineStats stats;
+    for (int i=0; i<PipelineStats::Window + 10; ++i)
+        stats.record(PipelineStats::Ingest, i, 1, 0);
+    stats.record(PipelineStats::Paint, 42);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QVERIFY(stats.save(file.fileName()));
+
+    auto lines = file.readAll().split('\n');
+    QCOMPARE(lines.first(), QByteArray("stage,tick,nsecs,pointsIn,pointsOut"));
+    QCOMPARE(lines[1], QByteArray("ingest,10,10,1,0"));
+    QCOMPARE(lines[PipelineStats::Window + 1], QByteArray("paint,0,42,0,0"));
+    QCOMPARE(lines.size(), PipelineStats::Window + 3);
+}
+
+QTEST_GUILESS_MAIN(TestPipelineStats)
+
+#include "testpipelinestats.moc"
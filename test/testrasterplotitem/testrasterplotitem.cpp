@@ -0,0 +1,235 @@
+#include <QtTest>
+
+#include "../../src/rasterplotitem.h"
+
+#include <QApplication>
+#include <QChart>
+#include <QGraphicsLayout>
+#include <QLineSeries>
+#include <QValueAxis>
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace {
+
+const int Width = 256;
+const int Height = 128;
+
+// 1024 ms are 256 px wide, so every block of 64 ms scrolls by 16 px.
+const int Span = 1024;
+const int Block = 64;
+
+/**
+ * @brief The same points in an item that scrolls its pixmap and in one
+ *        that draws everything again for every paint.
+ *
+ * Every block holds a plateau from 8 to 56 ms and rises to the next one
+ * in between. The view ends 32 ms into a block, so its edges and the
+ * strips drawn after a scroll start on a plateau, where clipping cannot
+ * move a pixel of the line.
+ */
+class Plot
+{
+public:
+    Plot()
+        : scrolled(&chart, &axisX, &axisY)
+        , full(&chart, &axisX, &axisY)
+    {
+        series.setPen(QPen(Qt::black, 0));
+        axisY.setRange(0, Height);
+        scrolled.setScrolling(true);
+        scrolled.setSeries({ &series });
+        full.setSeries({ &series });
+        resize(Width);
+    }
+
+    void resize(int width) {
+        chart.resize(width + 100, Height + 100);
+        chart.setPlotArea(QRectF(0, 0, width, Height));
+        chart.layout()->activate();
+    }
+
+    void addBlocks(int count) {
+        for (int i=0; i<count; ++i) {
+            auto unchanged = points.size();
+            auto y = 20 + (blocks * 37) % 90;
+            points.append(QPointF(blocks * Block + 8, y));
+            points.append(QPointF(blocks * Block + 56, y));
+            ++blocks;
+            scrolled.setPoints(0, points, unchanged);
+            full.setPoints(0, points);
+        }
+    }
+
+    void showUntil(qreal maxX, qreal span = Span) {
+        axisX.setRange(maxX - span, maxX);
+    }
+
+    void follow() {
+        showUntil(blocks * Block + Block / 2);
+    }
+
+    /**
+     * @brief Whether both items paint the same, non-empty image.
+     */
+    bool compare() {
+        auto scrolledImage = paint(scrolled);
+        auto fullImage = paint(full);
+        if (scrolledImage != fullImage) {
+            qWarning("The scrolled frame from %g to %g differs from the full redraw.",
+                     axisX.min(), axisX.max());
+            return false;
+        }
+        QImage empty(fullImage.size(), fullImage.format());
+        empty.fill(Qt::transparent);
+        return fullImage != empty;
+    }
+
+    static QImage paint(RasterPlotItem &item) {
+        QImage image(item.boundingRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        {
+            QPainter painter(&image);
+            item.paint(&painter, nullptr, nullptr);
+        }
+        return image;
+    }
+
+    QChart chart;
+    QValueAxis axisX;
+    QValueAxis axisY;
+    QLineSeries series;
+    RasterPlotItem scrolled;
+    RasterPlotItem full;
+    QVector<QPointF> points;
+    int blocks = 0;
+};
+
+} // namespace
+
+class TestRasterPlotItem : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRasterPlotItem();
+    ~TestRasterPlotItem();
+
+private slots:
+    void testScroll();
+    void testJumpBack();
+    void testZoom();
+    void testResize();
+};
+
+TestRasterPlotItem::TestRasterPlotItem()
+{
+
+}
+
+TestRasterPlotItem::~TestRasterPlotItem()
+{
+
+}
+
+void TestRasterPlotItem::testScroll()
+{
+    Plot plot;
+    QTRY_COMPARE(plot.scrolled.boundingRect().size(), QSizeF(Width, Height));
+    plot.addBlocks(20);
+    plot.follow();
+    QVERIFY(plot.compare());
+
+    // Every frame scrolls the pixmap and draws the new block only.
+    for (int i=0; i<40; ++i) {
+        plot.addBlocks(1);
+        plot.follow();
+        QVERIFY(plot.compare());
+    }
+
+    // Several blocks at once, and a frame without new points.
+    plot.addBlocks(3);
+    plot.follow();
+    QVERIFY(plot.compare());
+    QVERIFY(plot.compare());
+}
+
+void TestRasterPlotItem::testJumpBack()
+{
+    Plot plot;
+    QTRY_COMPARE(plot.scrolled.boundingRect().size(), QSizeF(Width, Height));
+    plot.addBlocks(40);
+    plot.follow();
+    QVERIFY(plot.compare());
+
+    // A view to the left of the pixmap is drawn again as a whole.
+    plot.showUntil(20 * Block + Block / 2);
+    QVERIFY(plot.compare());
+
+    // And so is a view that moved further than its width.
+    plot.addBlocks(1);
+    plot.follow();
+    QVERIFY(plot.compare());
+
+    for (int i=0; i<5; ++i) {
+        plot.addBlocks(1);
+        plot.follow();
+        QVERIFY(plot.compare());
+    }
+}
+
+void TestRasterPlotItem::testZoom()
+{
+    Plot plot;
+    QTRY_COMPARE(plot.scrolled.boundingRect().size(), QSizeF(Width, Height));
+    plot.addBlocks(40);
+    plot.follow();
+    QVERIFY(plot.compare());
+
+    // A different width or y range cannot reuse the pixmap.
+    auto maxX = plot.blocks * Block + Block / 2;
+    plot.showUntil(maxX, Span / 2);
+    QVERIFY(plot.compare());
+    plot.showUntil(maxX);
+    QVERIFY(plot.compare());
+    plot.axisY.setRange(0, 2 * Height);
+    QVERIFY(plot.compare());
+
+    for (int i=0; i<5; ++i) {
+        plot.addBlocks(1);
+        plot.follow();
+        QVERIFY(plot.compare());
+    }
+}
+
+void TestRasterPlotItem::testResize()
+{
+    Plot plot;
+    QTRY_COMPARE(plot.scrolled.boundingRect().size(), QSizeF(Width, Height));
+    plot.addBlocks(40);
+    plot.follow();
+    QVERIFY(plot.compare());
+
+    // Twice as wide, a block scrolls by 32 px.
+    plot.resize(2 * Width);
+    QTRY_COMPARE(plot.scrolled.boundingRect().size(), QSizeF(2 * Width, Height));
+    QVERIFY(plot.compare());
+
+    for (int i=0; i<5; ++i) {
+        plot.addBlocks(1);
+        plot.follow();
+        QVERIFY(plot.compare());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Pixmaps need a GUI application, but no display.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    TestRasterPlotItem test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "testrasterplotitem.moc"
@@ -0,0 +1,13 @@
+QT += testlib widgets charts
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/rasterplotitem.h
+
+SOURCES +=  \
+    testrasterplotitem.cpp  \
+    ../../src/rasterplotitem.cpp
@@ -0,0 +1,206 @@
+#include <QtTest>
+
+#include "../../src/recordingloader.h"
+
+class TestRecordingLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRecordingLoader();
+    ~TestRecordingLoader();
+
+private slots:
+    void testLoad_data();
+    void testLoad();
+    void testCancel();
+    void testSession();
+    void testSchema();
+    void testMissingFile();
+
+private:
+    static QByteArray lines(int count, bool header, bool newline);
+};
+
+TestRecordingLoader::TestRecordingLoader()
+{
+
+}
+
+TestRecordingLoader::~TestRecordingLoader()
+{
+
+}
+
+void TestRecordingLoader::testLoad_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<bool>("header");
+    QTest::addColumn<bool>("newline");
+
+    QTest::addRow("empty") << 0 << false << false;
+    QTest::addRow("single chunk") << 100 << true << true;
+    QTest::addRow("no final newline") << 100 << true << false;
+    QTest::addRow("several chunks") << 400000 << true << true;
+}
+
+void TestRecordingLoader::testLoad()
+{
+    QFETCH(int, count);
+    QFETCH(bool, header);
+    QFETCH(bool, newline);
+
+    auto contents = lines(count, header, newline);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(contents);
+    file.close();
+
+    RecordingLoader loader;
+    QVector<Sample> samples;
+    int chunks = 0;
+    connect(&loader, &RecordingLoader::samplesLoaded, [&](const QVector<Sample> &chunk) {
+        samples.append(chunk);
+        ++chunks;
+    });
+    QSignalSpy finished(&loader, &RecordingLoader::finished);
+
+    QVERIFY(loader.open(file.fileName()));
+    QCOMPARE(loader.data(), contents);
+    QCOMPARE(loader.schema(), ChannelSchema());
+    QVERIFY(finished.wait(10000));
+    QCOMPARE(finished.first().first().toBool(), false);
+
+    QCOMPARE(samples.size(), count);
+    for (int i=0; i<samples.size(); ++i) {
+        if (samples[i].ms != i * 5.0 || samples[i].values[1] != i % 1000)
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(i)));
+    }
+    if (contents.size() > 2 * (1 << 20))
+        QVERIFY(chunks > 1);
+}
+
+void TestRecordingLoader::testCancel()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(lines(400000, true, true));
+    file.close();
+
+    RecordingLoader loader;
+    int emitted = 0;
+    connect(&loader, &RecordingLoader::samplesLoaded, [&] { ++emitted; });
+    connect(&loader, &RecordingLoader::finished, [&] { ++emitted; });
+
+    QVERIFY(loader.open(file.fileName()));
+    loader.cancel();
+    QVERIFY(!loader.isLoading());
+
+    // Nothing of the canceled load may arrive afterwards.
+    QCoreApplication::processEvents();
+    QCOMPARE(emitted, 0);
+}
+
+void TestRecordingLoader::testSession()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.close();
+
+    const int count = 100000;
+    SessionWriter writer;
+    QVERIFY(writer.open(file.fileName()));
+    for (int i=0; i<count; ++i) {
+        Sample sample;
+        sample.ms = i * 5.0;
+        sample.values[1] = i % 1000;
+        QVERIFY(writer.append(sample));
+    }
+    QVERIFY(writer.close());
+
+    RecordingLoader loader;
+    QSignalSpy loaded(&loader, &RecordingLoader::samplesLoaded);
+    QSignalSpy finished(&loader, &RecordingLoader::finished);
+
+    // Only the index is read; the chunks are decoded on demand.
+    QVERIFY(loader.open(file.fileName()));
+    QVERIFY(loader.isSession());
+    QVERIFY(!loader.isLoading());
+    QVERIFY(loader.data().isEmpty());
+    QCOMPARE(loader.session().sampleCount(), qint64(count));
+
+    auto &chunks = loader.session().chunks();
+    QCOMPARE(chunks.size(), (count + SessionFile::ChunkSize - 1) / SessionFile::ChunkSize);
+    QVector<Sample> samples;
+    loader.session().read(chunks.size() - 1, samples);
+    auto first = (chunks.size() - 1) * SessionFile::ChunkSize;
+    QCOMPARE(samples.size(), count - first);
+    for (int i=0; i<samples.size(); ++i) {
+        if (samples[i].ms != (first + i) * 5.0 || samples[i].values[1] != (first + i) % 1000)
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(first + i)));
+    }
+
+    QCoreApplication::processEvents();
+    QCOMPARE(loaded.count(), 0);
+    QCOMPARE(finished.count(), 0);
+}
+
+void TestRecordingLoader::testSchema()
+{
+    // The channels are taken from the header.
+    QByteArray contents("ms,sync,a,b,c,d,e,f,g,h\n");
+    for (int i=0; i<100; ++i) {
+        contents.append(QByteArray::number(i * 5)).append(",0");
+        for (int channel=0; channel<8; ++channel)
+            contents.append(',').append(QByteArray::number(channel * i));
+        contents.append('\n');
+    }
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(contents);
+    file.close();
+
+    RecordingLoader loader;
+    QVector<Sample> samples;
+    connect(&loader, &RecordingLoader::samplesLoaded, [&](const QVector<Sample> &chunk) {
+        samples.append(chunk);
+    });
+    QSignalSpy finished(&loader, &RecordingLoader::finished);
+
+    QVERIFY(loader.open(file.fileName()));
+    QCOMPARE(loader.schema().count(), 8);
+    QCOMPARE(loader.schema().name(7), QString("h"));
+    QVERIFY(finished.wait(10000));
+
+    QCOMPARE(samples.size(), 100);
+    for (int i=0; i<samples.size(); ++i) {
+        if (samples[i].ms != i * 5.0 || samples[i].values[7] != 7 * i)
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(i)));
+    }
+}
+
+void TestRecordingLoader::testMissingFile()
+{
+    RecordingLoader loader;
+    QVERIFY(!loader.open("does-not-exist.csv"));
+    QVERIFY(!loader.errorString().isEmpty());
+    QVERIFY(loader.data().isEmpty());
+}
+
+QByteArray TestRecordingLoader::lines(int count, bool header, bool newline)
+{
+    QByteArray data;
+    if (header)
+        data.append("ms,sync,air1,air2,air3,pulse\r\n");
+    for (int i=0; i<count; ++i) {
+        data.append(QByteArray::number(i * 5)).append(",0,512,");
+        data.append(QByteArray::number(i % 1000)).append(",300,0");
+        if (newline || i < count - 1)
+            data.append("\r\n");
+    }
+    return data;
+}
+
+QTEST_GUILESS_MAIN(TestRecordingLoader)
+
+#include "testrecordingloader.moc"
@@ -0,0 +1,21 @@
+QT += testlib concurrent
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/csvparser.h \
+    ../../src/recordingloader.h \
+    ../../src/sample.h \
+    ../../src/sessionfile.h
+
+SOURCES +=  \
+    testrecordingloader.cpp  \
+    ../../src/channelschema.cpp \
+    ../../src/csvparser.cpp \
+    ../../src/recordingloader.cpp \
+    ../../src/sessionfile.cpp
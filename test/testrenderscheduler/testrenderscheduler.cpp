@@ -0,0 +1,113 @@
+#include <QtTest>
+
+#include "../../src/renderscheduler.h"
+
+class TestRenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestRenderScheduler();
+    ~TestRenderScheduler();
+
+private slots:
+    void testCoalesce();
+    void testFrameRate();
+    void testAdaptiveInterval();
+    void testPaintCost();
+
+};
+
+TestRenderScheduler::TestRenderScheduler()
+{
+
+}
+
+TestRenderScheduler::~TestRenderScheduler()
+{
+
+}
+
+void TestRenderScheduler::testCoalesce()
+{
+    RenderScheduler scheduler;
+    QSignalSpy render(&scheduler, &RenderScheduler::render);
+
+    for (int i=0; i<10; ++i)
+        scheduler.requestRender();
+    QVERIFY(render.wait(1000));
+    QTest::qWait(3 * scheduler.interval());
+    QCOMPARE(render.count(), 1);
+}
+
+void TestRenderScheduler::testFrameRate()
+{
+    RenderScheduler scheduler;
+    scheduler.setFrameRate(10);
+    QCOMPARE(scheduler.interval(), 100);
+
+    int frames = 0;
+    connect(&scheduler, &RenderScheduler::render, [&] { ++frames; });
+
+    // Requests every 10 ms are drawn every 100 ms at most.
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while (elapsed.elapsed() < 500) {
+        scheduler.requestRender();
+        QTest::qWait(10);
+    }
+    QVERIFY(frames >= 2);
+    QVERIFY(frames <= 6);
+}
+
+void TestRenderScheduler::testAdaptiveInterval()
+{
+    RenderScheduler scheduler;
+    scheduler.setFrameRate(30);
+    QCOMPARE(scheduler.interval(), 34);
+
+    for (int i=0; i<20; ++i)
+        scheduler.frameRendered(5.0);
+    QCOMPARE(scheduler.interval(), 34);
+
+    // Frames of 50 ms leave the other half of 100 ms to the event loop.
+    for (int i=0; i<50; ++i)
+        scheduler.frameRendered(50.0);
+    QCOMPARE(scheduler.interval(), 100);
+
+    // A single slow frame does not halve the frame rate.
+    for (int i=0; i<50; ++i)
+        scheduler.frameRendered(5.0);
+    scheduler.frameRendered(40.0);
+    QVERIFY(scheduler.interval() < 40);
+
+    for (int i=0; i<50; ++i)
+        scheduler.frameRendered(10000.0);
+    QCOMPARE(scheduler.interval(), 1000);
+
+    for (int i=0; i<100; ++i)
+        scheduler.frameRendered(1.0);
+    QCOMPARE(scheduler.interval(), 34);
+}
+
+void TestRenderScheduler::testPaintCost()
+{
+    RenderScheduler scheduler;
+    scheduler.setFrameRate(30);
+
+    // Cheap frames that are expensive to paint slow down the frame rate
+    // as well.
+    for (int i=0; i<20; ++i)
+        scheduler.frameRendered(5.0);
+    for (int i=0; i<50; ++i)
+        scheduler.framePainted(45.0);
+    QCOMPARE(scheduler.interval(), 100);
+
+    for (int i=0; i<100; ++i)
+        scheduler.framePainted(1.0);
+    QCOMPARE(scheduler.interval(), 34);
+}
+
+QTEST_GUILESS_MAIN(TestRenderScheduler)
+
+#include "testrenderscheduler.moc"
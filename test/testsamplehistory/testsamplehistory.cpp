@@ -0,0 +1,151 @@
+#include <QtTest>
+
+#include "../../src/samplehistory.h"
+
+class TestSampleHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSampleHistory();
+    ~TestSampleHistory();
+
+private slots:
+    void testAppend();
+    void testBacklog();
+    void testClose();
+    void testOpenFails();
+
+private:
+    static Sample sample(int i);
+};
+
+TestSampleHistory::TestSampleHistory()
+{
+
+}
+
+TestSampleHistory::~TestSampleHistory()
+{
+
+}
+
+void TestSampleHistory::testAppend()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    SampleHistory history;
+    QVERIFY(history.open(dir.filePath("history.mpts"), ChannelSchema()));
+    QVERIFY(history.isOpen());
+    const int count = 3 * SessionFile::ChunkSize + 100;
+    for (int i=0; i<count; ++i)
+        QVERIFY(history.append(sample(i)));
+
+    // Only complete chunks are on disk, and readable while still writing.
+    // They are written on a thread of their own.
+    QTRY_COMPARE(history.written(), qint64(3 * SessionFile::ChunkSize));
+    QThread::msleep(100);
+    QCOMPARE(history.written(), qint64(3 * SessionFile::ChunkSize));
+    auto &reader = history.reader();
+    QCOMPARE(reader.chunks().size(), 3);
+    QCOMPARE(reader.findChunk(sample(SessionFile::ChunkSize).ms), 1);
+
+    QVector<Sample> samples;
+    reader.read(2, samples);
+    QCOMPARE(samples.size(), SessionFile::ChunkSize);
+    for (int i=0; i<samples.size(); ++i) {
+        auto expected = sample(2 * SessionFile::ChunkSize + i);
+        if (samples[i].ms != expected.ms || samples[i].values[1] != expected.values[1] ||
+                samples[i].values[3] != expected.values[3])
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(i)));
+    }
+
+    // The file grew since it was mapped.
+    for (int i=count; i<4 * SessionFile::ChunkSize; ++i)
+        QVERIFY(history.append(sample(i)));
+    QTRY_COMPARE(history.written(), qint64(4 * SessionFile::ChunkSize));
+    QCOMPARE(history.reader().chunks().size(), 4);
+}
+
+void TestSampleHistory::testBacklog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    // Far more samples than the queue holds, without giving the writer
+    // time; the ones held back are written in order.
+    SampleHistory history;
+    QVERIFY(history.open(dir.filePath("history.mpts"), ChannelSchema()));
+    const int count = 100 * SessionFile::ChunkSize + 10;
+    for (int i=0; i<count; ++i)
+        QVERIFY(history.append(sample(i)));
+    history.close();
+    QCOMPARE(history.written(), qint64(count));
+
+    auto &reader = history.reader();
+    QCOMPARE(reader.sampleCount(), qint64(count));
+    QVector<Sample> samples;
+    for (int i=0; i<reader.chunks().size(); ++i)
+        reader.read(i, samples);
+    for (int i=0; i<count; ++i) {
+        if (samples[i].ms != sample(i).ms)
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(i)));
+    }
+}
+
+void TestSampleHistory::testClose()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("history.mpts");
+
+    SampleHistory history;
+    QVERIFY(history.open(fileName, ChannelSchema()));
+    const int count = SessionFile::ChunkSize + 10;
+    for (int i=0; i<count; ++i)
+        QVERIFY(history.append(sample(i)));
+    history.close();
+    QVERIFY(!history.isOpen());
+    QVERIFY(!history.append(sample(count)));
+
+    // Closing writes the rest and the index; the history stays readable.
+    QCOMPARE(history.written(), qint64(count));
+    QCOMPARE(history.reader().sampleCount(), qint64(count));
+
+    // What is left is a regular session file.
+    history.clear();
+    QVERIFY(history.reader().chunks().isEmpty());
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    auto data = file.readAll();
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.sampleCount(), qint64(count));
+}
+
+void TestSampleHistory::testOpenFails()
+{
+    SampleHistory history;
+    QVERIFY(!history.open("does/not/exist/history.mpts", ChannelSchema()));
+    QVERIFY(!history.isOpen());
+    QVERIFY(!history.errorString().isEmpty());
+    QVERIFY(!history.append(sample(0)));
+    QCOMPARE(history.written(), qint64(0));
+}
+
+Sample TestSampleHistory::sample(int i)
+{
+    Sample sample;
+    sample.ms = i * 5.0;
+    sample.sync = i % 2;
+    sample.values[0] = 512;
+    sample.values[1] = i % 1000;
+    sample.values[2] = 300;
+    sample.values[3] = i % 7;
+    return sample;
+}
+
+QTEST_APPLESS_MAIN(TestSampleHistory)
+
+#include "testsamplehistory.moc"
@@ -0,0 +1,20 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/sample.h \
+    ../../src/samplehistory.h \
+    ../../src/sessionfile.h \
+    ../../src/spscqueue.h
+
+SOURCES +=  \
+    testsamplehistory.cpp  \
+    ../../src/channelschema.cpp \
+    ../../src/samplehistory.cpp \
+    ../../src/sessionfile.cpp
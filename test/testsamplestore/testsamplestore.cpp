@@ -0,0 +1,129 @@
+#include <QtTest>
+
+#include "../../src/samplestore.h"
+
+class TestSampleStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSampleStore();
+    ~TestSampleStore();
+
+private slots:
+    void testAppend();
+    void testRemoveFirst();
+    void testBounds();
+    void testChannelCount();
+
+private:
+    static Sample sample(int i);
+};
+
+TestSampleStore::TestSampleStore()
+{
+
+}
+
+TestSampleStore::~TestSampleStore()
+{
+
+}
+
+void TestSampleStore::testAppend()
+{
+    SampleStore store;
+    QVERIFY(store.isEmpty());
+    QVERIFY(store.channel(0).isEmpty());
+
+    const int count = 1000;
+    for (int i=0; i<count; ++i)
+        store.append(sample(i));
+    QCOMPARE(store.size(), count);
+
+    // All channels share the time column, the values are exact.
+    auto air1 = store.channel(0);
+    auto air2 = store.channel(1);
+    auto pulse = store.channel(3);
+    QCOMPARE(air1.size(), count);
+    QCOMPARE(air1.x(), air2.x());
+    for (int i=0; i<count; ++i) {
+        auto expected = sample(i);
+        if (air1[i] != QPointF(expected.ms, expected.values[0]) ||
+                air2[i] != QPointF(expected.ms, expected.values[1]) ||
+                pulse[i] != QPointF(expected.ms, expected.values[3]))
+            QFAIL(qPrintable(QString("Sample %1 differs.").arg(i)));
+    }
+    QCOMPARE(air2.first(), QPointF(0.0, 0.0));
+    QCOMPARE(air2.last(), QPointF((count-1) * 5.0, (count-1) * 1000.0));
+
+    store.clear();
+    QVERIFY(store.isEmpty());
+    QCOMPARE(store.channel(2).size(), 0);
+}
+
+void TestSampleStore::testRemoveFirst()
+{
+    SampleStore store;
+    for (int i=0; i<100; ++i)
+        store.append(sample(i));
+
+    store.removeFirst(40);
+    QCOMPARE(store.size(), 60);
+    auto air3 = store.channel(2);
+    QCOMPARE(air3.first(), QPointF(40 * 5.0, 300.0));
+    QCOMPARE(air3.last(), QPointF(99 * 5.0, 300.0));
+
+    store.removeFirst(1000);
+    QVERIFY(store.isEmpty());
+}
+
+void TestSampleStore::testBounds()
+{
+    SampleStore store;
+    for (int i=0; i<100; ++i)
+        store.append(sample(i));
+
+    auto view = store.channel(0);
+    QCOMPARE(view.lowerBound(-1.0), 0);
+    QCOMPARE(view.lowerBound(50.0), 10);
+    QCOMPARE(view.lowerBound(51.0), 11);
+    QCOMPARE(view.upperBound(50.0), 11);
+    QCOMPARE(view.upperBound(1000.0), 100);
+}
+
+void TestSampleStore::testChannelCount()
+{
+    SampleStore store;
+    QCOMPARE(store.channelCount(), 4);
+    store.append(sample(0));
+
+    // Changing the channels drops what was stored.
+    store.setChannelCount(Sample::MaxChannels);
+    QCOMPARE(store.channelCount(), int(Sample::MaxChannels));
+    QVERIFY(store.isEmpty());
+
+    Sample wide;
+    wide.ms = 1.0;
+    for (int i=0; i<Sample::MaxChannels; ++i)
+        wide.values[i] = 10 * i;
+    store.append(wide);
+    for (int i=0; i<Sample::MaxChannels; ++i)
+        QCOMPARE(store.channel(i).first(), QPointF(1.0, 10.0 * i));
+}
+
+Sample TestSampleStore::sample(int i)
+{
+    Sample sample;
+    sample.ms = i * 5.0;
+    sample.sync = i % 2;
+    sample.values[0] = 512 - i % 3;
+    sample.values[1] = i * 1000;
+    sample.values[2] = 300;
+    sample.values[3] = i % 7;
+    return sample;
+}
+
+QTEST_APPLESS_MAIN(TestSampleStore)
+
+#include "testsamplestore.moc"
@@ -0,0 +1,18 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/channelview.h \
+    ../../src/sample.h \
+    ../../src/samplestore.h
+
+SOURCES +=  \
+    testsamplestore.cpp  \
+    ../../src/channelschema.cpp \
+    ../../src/samplestore.cpp
@@ -0,0 +1,257 @@
+#include <QtTest>
+
+#include "../../src/sessionfile.h"
+
+class TestSessionFile : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSessionFile();
+    ~TestSessionFile();
+
+private slots:
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testChunkHeaders();
+    void testFindChunk();
+    void testWithoutIndex();
+    void testSchema();
+    void testFirstVersion();
+    void testNotASession();
+    void testSaveFile();
+
+private:
+    static QVector<Sample> samples(int count, int channels = 4);
+    static QByteArray write(const QVector<Sample> &samples, int flushAt = -1,
+                            const ChannelSchema &schema = ChannelSchema());
+    static QVector<Sample> readAll(const SessionReader &reader);
+    static bool equal(const Sample &a, const Sample &b, int channels = 4);
+};
+
+TestSessionFile::TestSessionFile()
+{
+
+}
+
+TestSessionFile::~TestSessionFile()
+{
+
+}
+
+void TestSessionFile::testRoundTrip_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("flushAt");
+
+    QTest::addRow("empty") << 0 << -1;
+    QTest::addRow("one") << 1 << -1;
+    QTest::addRow("full chunk") << SessionFile::ChunkSize << -1;
+    QTest::addRow("several chunks") << 3 * SessionFile::ChunkSize + 17 << -1;
+    QTest::addRow("flushed") << 10000 << 5000;
+}
+
+void TestSessionFile::testRoundTrip()
+{
+    QFETCH(int, count);
+    QFETCH(int, flushAt);
+
+    auto expected = samples(count);
+    auto data = write(expected, flushAt);
+
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.sampleCount(), qint64(count));
+    auto actual = readAll(reader);
+    QCOMPARE(actual.size(), expected.size());
+    for (int i=0; i<count; ++i)
+        QVERIFY(equal(actual[i], expected[i]));
+}
+
+void TestSessionFile::testChunkHeaders()
+{
+    auto data = write(samples(2 * SessionFile::ChunkSize));
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.chunks().size(), 2);
+
+    auto &chunk = reader.chunks()[1];
+    QVector<Sample> rows;
+    reader.read(1, rows);
+    QCOMPARE(chunk.count, rows.size());
+    QCOMPARE(chunk.min.ms, rows.first().ms);
+    QCOMPARE(chunk.max.ms, rows.last().ms);
+    for (auto &row: rows) {
+        QVERIFY(chunk.min.values[0] <= row.values[0] && row.values[0] <= chunk.max.values[0]);
+        QVERIFY(chunk.min.values[3] <= row.values[3] && row.values[3] <= chunk.max.values[3]);
+    }
+}
+
+void TestSessionFile::testFindChunk()
+{
+    // 2 ms per sample, so every chunk covers 2 * ChunkSize ms.
+    auto data = write(samples(3 * SessionFile::ChunkSize));
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+
+    const qreal span = 2.0 * SessionFile::ChunkSize;
+    QCOMPARE(reader.findChunk(-1.0), 0);
+    QCOMPARE(reader.findChunk(0.0), 0);
+    QCOMPARE(reader.findChunk(span - 2.0), 0);
+    QCOMPARE(reader.findChunk(span - 1.0), 1);
+    QCOMPARE(reader.findChunk(2.5 * span), 2);
+    QCOMPARE(reader.findChunk(10.0 * span), 3);
+}
+
+void TestSessionFile::testWithoutIndex()
+{
+    // As if the application crashed while writing the third chunk.
+    auto expected = samples(3 * SessionFile::ChunkSize);
+    auto data = write(expected);
+    SessionReader complete;
+    QVERIFY(complete.open(data.constData(), data.size()));
+    data.truncate(static_cast<int>(complete.chunks()[2].offset) + 100);
+
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.chunks().size(), 2);
+    auto actual = readAll(reader);
+    QCOMPARE(actual.size(), 2 * SessionFile::ChunkSize);
+    for (int i=0; i<actual.size(); ++i)
+        QVERIFY(equal(actual[i], expected[i]));
+}
+
+void TestSessionFile::testSchema()
+{
+    QStringList names;
+    for (int i=0; i<12; ++i)
+        names.append(QString("ch%1").arg(i + 1));
+    ChannelSchema schema(names);
+    auto expected = samples(SessionFile::ChunkSize + 5, schema.count());
+    auto data = write(expected, -1, schema);
+
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.schema().names(), names);
+    QCOMPARE(reader.chunks().size(), 2);
+    QCOMPARE(reader.chunks().first().min.values[11], expected.first().values[11]);
+    auto actual = readAll(reader);
+    QCOMPARE(actual.size(), expected.size());
+    for (int i=0; i<actual.size(); ++i)
+        QVERIFY(equal(actual[i], expected[i], schema.count()));
+}
+
+void TestSessionFile::testFirstVersion()
+{
+    // Version 1 had no schema behind the version; its index is not found
+    // at the shifted offset, so the chunks are scanned.
+    auto expected = samples(2 * SessionFile::ChunkSize);
+    auto data = write(expected);
+    auto schemaSize = 4 + ChannelSchema().header().size();
+    data.remove(8, schemaSize);
+    data[4] = 1;
+
+    SessionReader reader;
+    QVERIFY(reader.open(data.constData(), data.size()));
+    QCOMPARE(reader.schema(), ChannelSchema());
+    auto actual = readAll(reader);
+    QCOMPARE(actual.size(), expected.size());
+    for (int i=0; i<actual.size(); ++i)
+        QVERIFY(equal(actual[i], expected[i]));
+}
+
+void TestSessionFile::testNotASession()
+{
+    QByteArray data("ms,sync,air1,air2,air3,pulse\n1,0,1,1,1,1\n");
+    QVERIFY(!SessionFile::isSession(data.constData(), data.size()));
+    SessionReader reader;
+    QVERIFY(!reader.open(data.constData(), data.size()));
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+QVector<Sample> TestSessionFile::samples(int count, int channels)
+{
+    QVector<Sample> result;
+    for (int i=0; i<count; ++i) {
+        Sample sample;
+        sample.ms = 2.0 * i;
+        sample.sync = i % 2;
+        sample.values[0] = 300 + (i * 7919) % 41;
+        sample.values[1] = -i;
+        sample.values[2] = 3 * i;
+        sample.values[3] = i % 100;
+        for (int channel=4; channel<channels; ++channel)
+            sample.values[channel] = channel * i;
+        result.append(sample);
+    }
+    return result;
+}
+
+void TestSessionFile::testSaveFile()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto fileName = dir.filePath("session.mpts");
+    QFile old(fileName);
+    QVERIFY(old.open(QFile::WriteOnly));
+    old.write("old");
+    old.close();
+
+    // The target keeps its content until the complete session is
+    // committed.
+    auto expected = samples(2 * SessionFile::ChunkSize + 5);
+    QSaveFile file(fileName);
+    QVERIFY(file.open(QFile::WriteOnly));
+    SessionWriter writer;
+    QVERIFY(writer.open(&file));
+    for (auto &sample: expected)
+        QVERIFY(writer.append(sample));
+    QVERIFY(writer.close());
+    QVERIFY(!writer.isOpen());
+    QVERIFY(file.isOpen());
+    QVERIFY(old.open(QFile::ReadOnly));
+    QCOMPARE(old.readAll(), QByteArray("old"));
+    old.close();
+
+    QVERIFY(file.commit());
+    QVERIFY(old.open(QFile::ReadOnly));
+    QCOMPARE(old.readAll(), write(expected));
+}
+
+QByteArray TestSessionFile::write(const QVector<Sample> &samples, int flushAt,
+                                  const ChannelSchema &schema)
+{
+    QTemporaryFile file;
+    file.open();
+    file.close();
+
+    SessionWriter writer;
+    writer.open(file.fileName(), schema);
+    for (int i=0; i<samples.size(); ++i) {
+        writer.append(samples[i]);
+        if (i == flushAt)
+            writer.flush();
+    }
+    writer.close();
+
+    file.open();
+    return file.readAll();
+}
+
+QVector<Sample> TestSessionFile::readAll(const SessionReader &reader)
+{
+    QVector<Sample> result;
+    for (int i=0; i<reader.chunks().size(); ++i)
+        reader.read(i, result);
+    return result;
+}
+
+bool TestSessionFile::equal(const Sample &a, const Sample &b, int channels)
+{
+    return a.ms == b.ms && a.sync == b.sync &&
+            std::equal(a.values, a.values + channels, b.values);
+}
+
+QTEST_APPLESS_MAIN(TestSessionFile)
+
+#include "testsessionfile.moc"
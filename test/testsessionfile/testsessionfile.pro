@@ -0,0 +1,17 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelschema.h \
+    ../../src/sample.h \
+    ../../src/sessionfile.h
+
+SOURCES +=  \
+    testsessionfile.cpp  \
+    ../../src/channelschema.cpp \
+    ../../src/sessionfile.cpp
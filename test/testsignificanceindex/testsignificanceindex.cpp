@@ -0,0 +1,139 @@
+#include <QtTest>
+
+#include "../../src/significanceindex.h"
+
+class TestSignificanceIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSignificanceIndex();
+    ~TestSignificanceIndex();
+
+private slots:
+    void testRemoveFirst_data();
+    void testRemoveFirst();
+
+private:
+    static QVector<QPointF> samples(int count, bool noisy);
+    static void verifyWithin(const ChannelView &data, const QVector<QPointF> &result,
+                             qreal epsilon);
+    static qreal distance(const QPointF &point, const QPointF &start,
+                          const QPointF &end);
+};
+
+TestSignificanceIndex::TestSignificanceIndex()
+{
+
+}
+
+TestSignificanceIndex::~TestSignificanceIndex()
+{
+
+}
+
+void TestSignificanceIndex::testRemoveFirst_data()
+{
+    QTest::addColumn<bool>("noisy");
+    QTest::addColumn<int>("count");
+
+    QTest::addRow("inside the first block") << true << 1000;
+    QTest::addRow("inside a later block") << true << 9000;
+    QTest::addRow("inside the open block") << true << 19000;
+
+    // Ticks start and end at 0, so no vertex but the block boundaries
+    // survives epsilon 5; a cut right before a jump from -4 to 4 leaves a
+    // first segment far off.
+    QTest::addRow("at a jump") << false << 1001;
+}
+
+void TestSignificanceIndex::testRemoveFirst()
+{
+    QFETCH(bool, noisy);
+    QFETCH(int, count);
+
+    // Fed a tick at a time, like the live buffers.
+    auto points = samples(20000, noisy);
+    ChannelBuffer columns;
+    SignificanceIndex index;
+    for (int i=0; i<points.size(); ++i) {
+        columns.append(points[i].x(), points[i].y());
+        if (i % 10 == 9)
+            index.update(columns);
+    }
+    auto before = index.values();
+    auto sealed = index.sealed();
+
+    ChannelBuffer trimmed(points.mid(count));
+    auto data = trimmed.view();
+    index.removeFirst(data, count);
+    QCOMPARE(index.values().size(), data.size());
+    QCOMPARE(index.sealed(), qMax(sealed - count, 0));
+
+    // Only the block the cut went through changed.
+    auto &values = index.values();
+    auto max = std::numeric_limits<qreal>::max();
+    QCOMPARE(values.first(), max);
+    auto end = 1;
+    while (values[end] < max)
+        ++end;
+    for (int i=end; i<values.size(); ++i)
+        QCOMPARE(values[i], before[count + i]);
+
+    for (auto epsilon: { 0.5, 2.0, 5.0 }) {
+        QVector<QPointF> result;
+        index.filter(data, data.size() - 1, epsilon, result);
+        QCOMPARE(result.first(), data.first());
+        QCOMPARE(result.last(), data.last());
+        verifyWithin(data, result, epsilon);
+    }
+
+    // Later samples continue the index as before.
+    columns = trimmed;
+    for (int i=0; i<2000; ++i)
+        columns.append(data.last().x() + 10.0 * (i + 1), i % 7);
+    index.update(columns);
+    QCOMPARE(index.values().size(), columns.size());
+}
+
+QVector<QPointF> TestSignificanceIndex::samples(int count, bool noisy)
+{
+    QVector<QPointF> points;
+    for (int i=0; i<count; ++i) {
+        auto y = noisy ? 300.0 + 40.0 * qSin(i / 25.0) + (i * 7919 % 13) - 6
+                       : (i % 10 == 0 || i % 10 == 9 ? 0.0 : i % 10 == 1 ? -4.0 : 4.0);
+        points.append(QPointF(i * 10.0, qRound(y)));
+    }
+    return points;
+}
+
+void TestSignificanceIndex::verifyWithin(const ChannelView &data,
+                                         const QVector<QPointF> &result,
+                                         qreal epsilon)
+{
+    // Every sample has to be within epsilon of the segment covering it.
+    int segment = 0;
+    for (int i=0; i<data.size(); ++i) {
+        auto point = data[i];
+        while (segment < result.size()-2 && result[segment+1].x() <= point.x())
+            ++segment;
+        QVERIFY(distance(point, result[segment], result[segment+1]) <= epsilon + 1e-9);
+    }
+}
+
+qreal TestSignificanceIndex::distance(const QPointF &point, const QPointF &start,
+                                      const QPointF &end)
+{
+    auto dx = end.x() - start.x();
+    auto dy = end.y() - start.y();
+    auto mag = qSqrt(dx * dx + dy * dy);
+    auto px = point.x() - start.x();
+    auto py = point.y() - start.y();
+    if (mag == 0.0)
+        return qSqrt(px * px + py * py);
+    return qAbs(dx * py - dy * px) / mag;
+}
+
+QTEST_APPLESS_MAIN(TestSignificanceIndex)
+
+#include "testsignificanceindex.moc"
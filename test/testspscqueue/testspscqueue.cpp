@@ -0,0 +1,103 @@
+#include <QtTest>
+
+#include "../../src/spscqueue.h"
+
+class TestSpscQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestSpscQueue();
+    ~TestSpscQueue();
+
+private slots:
+    void testCapacity_data();
+    void testCapacity();
+    void testFull();
+    void testProducerConsumer();
+};
+
+TestSpscQueue::TestSpscQueue()
+{
+
+}
+
+TestSpscQueue::~TestSpscQueue()
+{
+
+}
+
+void TestSpscQueue::testCapacity_data()
+{
+    QTest::addColumn<int>("requested");
+    QTest::addColumn<int>("capacity");
+
+    QTest::addRow("one") << 1 << 1;
+    QTest::addRow("power of two") << 64 << 64;
+    QTest::addRow("rounded up") << 100 << 128;
+}
+
+void TestSpscQueue::testCapacity()
+{
+    QFETCH(int, requested);
+    QFETCH(int, capacity);
+
+    SpscQueue<int> queue(requested);
+    QCOMPARE(queue.capacity(), capacity);
+    QVERIFY(queue.isEmpty());
+}
+
+void TestSpscQueue::testFull()
+{
+    SpscQueue<int> queue(4);
+    for (int i=0; i<4; ++i)
+        QVERIFY(queue.push(i));
+    QVERIFY(!queue.push(4));
+    QCOMPARE(queue.size(), 4);
+
+    int value;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 0);
+    QVERIFY(queue.push(4));
+    for (int i=1; i<5; ++i) {
+        QVERIFY(queue.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(!queue.pop(value));
+}
+
+void TestSpscQueue::testProducerConsumer()
+{
+    const int count = 1000000;
+    SpscQueue<int> queue(256);
+
+    auto producer = QThread::create([&queue, count] {
+        for (int i=0; i<count; ++i) {
+            while (!queue.push(i))
+                QThread::yieldCurrentThread();
+        }
+    });
+    producer->start();
+
+    // Every value must arrive exactly once and in order.
+    int expected = 0;
+    int value;
+    while (expected < count) {
+        if (queue.pop(value)) {
+            if (value != expected)
+                break;
+            ++expected;
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    producer->wait();
+    delete producer;
+
+    QCOMPARE(expected, count);
+    QVERIFY(queue.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(TestSpscQueue)
+
+#include "testspscqueue.moc"
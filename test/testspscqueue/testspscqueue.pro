@@ -0,0 +1,13 @@
+QT += testlib
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/spscqueue.h
+
+SOURCES +=  \
+    testspscqueue.cpp
@@ -0,0 +1,152 @@
+#include <QtTest>
+
+#include "../../src/streamingsimplifier.h"
+
+class TestStreamingSimplifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    TestStreamingSimplifier();
+    ~TestStreamingSimplifier();
+
+private slots:
+    void testStreamingSimplifier_data();
+    void testStreamingSimplifier();
+    void testFlatTail();
+    void testClearedBuffer();
+    void testUnchanged();
+
+private:
+    static qreal distance(const QPointF &point, const QPointF &start,
+                          const QPointF &end);
+};
+
+TestStreamingSimplifier::TestStreamingSimplifier()
+{
+
+}
+
+TestStreamingSimplifier::~TestStreamingSimplifier()
+{
+
+}
+
+void TestStreamingSimplifier::testStreamingSimplifier_data()
+{
+    QTest::addColumn<qreal>("epsilon");
+    QTest::addColumn<int>("chunk");
+
+    QTest::addRow("eps 0.5, chunk 1") << 0.5 << 1;
+    QTest::addRow("eps 2.0, chunk 5") << 2.0 << 5;
+    QTest::addRow("eps 2.0, chunk 50") << 2.0 << 50;
+    QTest::addRow("eps 5.0, chunk 17") << 5.0 << 17;
+}
+
+void TestStreamingSimplifier::testStreamingSimplifier()
+{
+    QFETCH(qreal, epsilon);
+    QFETCH(int, chunk);
+
+    StreamingSimplifier simplifier;
+    simplifier.setEpsilon(epsilon);
+
+    ChannelBuffer columns;
+    for (int i=0; i<2000; ++i) {
+        auto y = 300.0 + 40.0 * qSin(i / 25.0) + (i * 7919 % 13) - 6;
+        columns.append(i * 10.0, qRound(y));
+        if (i % chunk == 0)
+            simplifier.update(columns);
+    }
+    auto data = columns.view();
+    auto &result = simplifier.update(data);
+
+    QCOMPARE(result.first(), data.first());
+    QCOMPARE(result.last(), data.last());
+    QVERIFY(result.size() < data.size());
+
+    // Every sample has to be within epsilon of the segment covering it.
+    int segment = 0;
+    for (int i=0; i<data.size(); ++i) {
+        auto point = data[i];
+        while (segment < result.size()-2 && result[segment+1].x() <= point.x())
+            ++segment;
+        QVERIFY(distance(point, result[segment], result[segment+1]) <= epsilon + 1e-9);
+    }
+}
+
+void TestStreamingSimplifier::testFlatTail()
+{
+    StreamingSimplifier simplifier;
+    ChannelBuffer columns;
+    for (int i=0; i<20000; ++i) {
+        columns.append(i, 5.0);
+        if (i % 100 == 0)
+            simplifier.update(columns);
+    }
+    auto data = columns.view();
+    auto &result = simplifier.update(data);
+
+    QCOMPARE(result.first(), data.first());
+    QCOMPARE(result.last(), data.last());
+    QVERIFY(result.size() < 10);
+}
+
+void TestStreamingSimplifier::testClearedBuffer()
+{
+    StreamingSimplifier simplifier;
+    QVector<QPointF> data{ QPointF(0,0), QPointF(1,5), QPointF(2,0),
+                           QPointF(3,5), QPointF(4,0) };
+    simplifier.update(ChannelBuffer(data));
+
+    data = { QPointF(0,1), QPointF(1,1) };
+    QCOMPARE(simplifier.update(ChannelBuffer(data)), data);
+
+    data.clear();
+    QVERIFY(simplifier.update(ChannelBuffer(data)).isEmpty());
+}
+
+void TestStreamingSimplifier::testUnchanged()
+{
+    StreamingSimplifier simplifier;
+    ChannelBuffer columns;
+    QVector<QPointF> shown;
+    int redrawn = 0;
+    for (int i=0; i<5000; ++i) {
+        columns.append(i * 10.0, qRound(200.0 + 80.0 * qSin(i / 40.0)));
+        auto &result = simplifier.update(columns);
+
+        // Mirror the result like a series updated with the tail only.
+        auto unchanged = simplifier.unchanged();
+        QVERIFY(unchanged <= shown.size());
+        shown.resize(unchanged);
+        for (int j=unchanged; j<result.size(); ++j)
+            shown.append(result[j]);
+        redrawn += result.size() - unchanged;
+        simplifier.markUnchanged();
+        QCOMPARE(shown, result);
+    }
+
+    // Mostly the moving last vertex, rather than the whole result.
+    QVERIFY(redrawn < 2 * columns.size());
+
+    simplifier.restart(shown, columns.size() - 1);
+    QCOMPARE(simplifier.unchanged(), 0);
+}
+
+qreal TestStreamingSimplifier::distance(const QPointF &point, const QPointF &start,
+                                        const QPointF &end)
+{
+    auto dx = end.x() - start.x();
+    auto dy = end.y() - start.y();
+    auto mag = qSqrt(dx * dx + dy * dy);
+    auto px = point.x() - start.x();
+    auto py = point.y() - start.y();
+    if (mag == 0.0)
+        return qSqrt(px * px + py * py);
+    return qAbs(dx * py - dy * px) / mag;
+}
+
+QTEST_APPLESS_MAIN(TestStreamingSimplifier)
+
+#include "teststreamingsimplifier.moc"
@@ -0,0 +1,19 @@
+QT += testlib concurrent
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS +=  \
+    ../../src/channelview.h \
+    ../../src/distancekernel.h \
+    ../../src/douglaspeucker.h \
+    ../../src/streamingsimplifier.h
+
+SOURCES +=  \
+    teststreamingsimplifier.cpp  \
+    ../../src/distancekernel.cpp \
+    ../../src/douglaspeucker.cpp \
+    ../../src/streamingsimplifier.cpp
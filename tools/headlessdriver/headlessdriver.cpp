@@ -0,0 +1,239 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "headlessdriver.h"
+
+#include <QChart>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QValueAxis>
+#include <QXYSeries>
+
+#include <ctime>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+HeadlessDriver::HeadlessDriver(const Options &options, QObject *parent)
+    : QObject(parent)
+    , _options(options)
+{
+    // The size and y range of a typical window.
+    _view.resize(1280, 600);
+    _view.axisX()->setRange(0, _reader.samples());
+    _view.axisY()->setRange(200, 350);
+    _reader.setAxisX(_view.axisX());
+    showChannels();
+    connect(&_reader, &SerialReader::schemaChanged, this, &HeadlessDriver::showChannels);
+    connect(&_view, &ChartView::painted, &_reader, &SerialReader::chartPainted);
+    connect(_view.chart(), &QChart::plotAreaChanged, this, [this](const QRectF &plotArea) {
+        _reader.setPlotWidth(qRound(plotArea.width()));
+    });
+    connect(&_reader, &SerialReader::arduinoStarted, this, [this] {
+        _handshake = _clock.elapsed();
+    });
+    connect(&_reader, &SerialReader::newData, this, [this](const QByteArray &data) {
+        _bytes += data.size();
+    });
+    connect(&_timer, &QTimer::timeout, this, &HeadlessDriver::read);
+    connect(&_simulator, &QProcess::readyReadStandardOutput,
+            this, &HeadlessDriver::simulatorOutput);
+    connect(&_simulator, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &HeadlessDriver::simulatorFinished);
+}
+
+void HeadlessDriver::start()
+{
+    _view.show();
+    if (_options.simulator.isEmpty()) {
+        if (open(_options.portName))
+            QTimer::singleShot(qRound(_options.duration * 1000), this, &HeadlessDriver::stop);
+        return;
+    }
+
+    // The simulator prints its port first and waits for a line on stdin.
+    _simulator.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    _simulator.start(_options.simulator, _options.simulatorArguments);
+    if (!_simulator.waitForStarted())
+        fail("Failed to start " + _options.simulator + ": " + _simulator.errorString());
+}
+
+void HeadlessDriver::simulatorOutput()
+{
+    _simulatorOutput.append(_simulator.readAllStandardOutput());
+    forever {
+        auto newline = _simulatorOutput.indexOf('\n');
+        if (newline < 0)
+            return;
+        auto line = QString::fromLocal8Bit(_simulatorOutput.left(newline)).trimmed();
+        _simulatorOutput.remove(0, newline + 1);
+
+        if (line.startsWith("rows=")) {
+            _simulatorStatistics = line;
+        } else if (!_reader.isOpen() && !_clock.isValid()) {
+            if (!open(line))
+                return;
+            _simulator.write("\n");
+            QTimer::singleShot(qRound(_options.duration * 1000), this, &HeadlessDriver::stop);
+        }
+    }
+}
+
+void HeadlessDriver::simulatorFinished()
+{
+    // Its last rows may still be in the terminal.
+    simulatorOutput();
+    QTimer::singleShot(DrainTime, this, &HeadlessDriver::finish);
+}
+
+void HeadlessDriver::read()
+{
+    _reader.read();
+}
+
+void HeadlessDriver::stop()
+{
+    if (_simulator.state() == QProcess::Running)
+        _simulator.terminate();
+    else
+        finish();
+}
+
+void HeadlessDriver::finish()
+{
+    if (!_clock.isValid())
+        return;
+    _seconds = _clock.nsecsElapsed() / 1e9;
+    _cpu = cpuSeconds() - _cpuStart;
+    _reader.close();
+    _timer.stop();
+    _reader.read();
+    report();
+    _clock.invalidate();
+    emit finished(0);
+}
+
+void HeadlessDriver::showChannels()
+{
+    for (int i=0; i<_reader.channelCount(); ++i) {
+        auto series = _reader.series(i);
+        if (series->chart())
+            continue;
+        _view.chart()->addSeries(series);
+        series->attachAxis(_view.axisX());
+        series->attachAxis(_view.axisY());
+    }
+}
+
+bool HeadlessDriver::open(const QString &portName)
+{
+    // As in a live session of MainWindow.
+    if (!_directory.isValid() ||
+            !_reader.setHistoryFile(_directory.filePath("session.mpts"))) {
+        fail("Failed to create the history file.");
+        return false;
+    }
+    if (!_reader.open(portName, _options.baudRate)) {
+        fail(_reader.errorString());
+        return false;
+    }
+    _reader.stats().setEnabled(!_options.statsFile.isEmpty());
+    _cpuStart = cpuSeconds();
+    _clock.start();
+    _timer.start(10);
+    return true;
+}
+
+void HeadlessDriver::fail(const QString &error)
+{
+    QTextStream(stderr) << error << endl;
+    if (_simulator.state() == QProcess::Running)
+        _simulator.kill();
+    emit finished(1);
+}
+
+void HeadlessDriver::report()
+{
+    // One key=value pair per line, so scripts can collect runs.
+    QTextStream out(stdout);
+    auto samples = _reader.sampleCount();
+    out << "seconds=" << _seconds << endl;
+    out << "handshakeMs=" << _handshake << endl;
+    out << "samples=" << samples << endl;
+    out << "samplesPerSecond=" << samples / _seconds << endl;
+    out << "bytesPerSecond=" << _bytes / _seconds << endl;
+    out << "invalidLines=" << _reader.invalidLines() << endl;
+    out << "droppedSamples=" << _reader.droppedSamples() << endl;
+    out << "droppedChunks=" << _reader.droppedChunks() << endl;
+    out << "cpuSeconds=" << _cpu << endl;
+    out << "cpuPercent=" << 100.0 * _cpu / _seconds << endl;
+
+    auto &latency = _reader.latency();
+    out << "latencySamples=" << latency.count() << endl;
+    out << "latencyMeanMs=" << latency.mean() << endl;
+    out << "latencyP50Ms=" << latency.percentile(0.5) << endl;
+    out << "latencyP99Ms=" << latency.percentile(0.99) << endl;
+    out << "latencyMaxMs=" << latency.max() << endl;
+    if (!_options.latencyFile.isEmpty() && !latency.save(_options.latencyFile))
+        QTextStream(stderr) << "Failed to write " << _options.latencyFile << endl;
+
+    if (!_options.statsFile.isEmpty()) {
+        auto &stats = _reader.stats();
+        for (int i=0; i<PipelineStats::StageCount; ++i) {
+            auto stage = static_cast<PipelineStats::Stage>(i);
+            auto summary = stats.summary(stage);
+            out << PipelineStats::name(stage) << "P50Ms=" << summary.p50 << endl;
+            out << PipelineStats::name(stage) << "P99Ms=" << summary.p99 << endl;
+        }
+        if (!stats.save(_options.statsFile))
+            QTextStream(stderr) << "Failed to write " << _options.statsFile << endl;
+    }
+
+    if (_simulatorStatistics.isEmpty())
+        return;
+    qint64 rows = 0;
+    qint64 malformed = 0;
+    for (auto &pair: _simulatorStatistics.split(' ')) {
+        auto keyValue = pair.split('=');
+        if (keyValue.size() != 2)
+            continue;
+        if (keyValue[0] == "rows")
+            rows = keyValue[1].toLongLong();
+        else if (keyValue[0] == "malformed")
+            malformed = keyValue[1].toLongLong();
+    }
+    out << "sentRows=" << rows << endl;
+    out << "sentMalformed=" << malformed << endl;
+    out << "lostRows=" << rows - malformed - samples << endl;
+}
+
+qreal HeadlessDriver::cpuSeconds()
+{
+    // All threads of the process: the worker, the pool and the event loop.
+#ifdef Q_OS_UNIX
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+            + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#else
+    return static_cast<qreal>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,103 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HEADLESSDRIVER_H
+#define HEADLESSDRIVER_H
+
+#include "../../src/chartview.h"
+#include "../../src/serialreader.h"
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTimer>
+
+/**
+ * @brief Runs the acquisition of the application without its window and
+ *        reports how it kept up.
+ *
+ * The port is read by a SerialReader with a history file into a ChartView,
+ * just like a live session of MainWindow; the view is painted by the
+ * offscreen platform, so the latency up to the paint is real. The port is
+ * either given or created by a serial simulator started as a child
+ * process; then the rows it sent are compared with the ones received.
+ */
+class HeadlessDriver : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString portName;
+        QString simulator;
+        QStringList simulatorArguments;
+        QString statsFile;
+        QString latencyFile;
+        qint32 baudRate = 2000000;
+        qreal duration = 10.0;
+    };
+
+    explicit HeadlessDriver(const Options &options, QObject *parent = nullptr);
+
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void simulatorOutput();
+    void simulatorFinished();
+    void read();
+    void stop();
+    void finish();
+    void showChannels();
+
+private:
+    /**
+     * @brief Time given to the samples still in the terminal's buffer once
+     *        the simulator stopped, in ms.
+     */
+    static const int DrainTime = 500;
+
+    bool open(const QString &portName);
+    void fail(const QString &error);
+    void report();
+    static qreal cpuSeconds();
+
+    Options _options;
+    QProcess _simulator;
+    QByteArray _simulatorOutput;
+    QString _simulatorStatistics;
+
+    QTemporaryDir _directory;
+    ChartView _view;
+    SerialReader _reader;
+    QTimer _timer;
+    QElapsedTimer _clock;
+    qint64 _handshake = -1;
+    qint64 _bytes = 0;
+    qreal _cpuStart = 0.0;
+    qreal _seconds = 0.0;
+    qreal _cpu = 0.0;
+};
+
+#endif // HEADLESSDRIVER_H
@@ -0,0 +1,70 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "headlessdriver.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+
+int main(int argc, char *argv[])
+{
+    // The chart is painted, but not displayed.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    app.setApplicationName("headlessdriver");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Reads a serial port like a live session of mpt-chart and reports "
+                "throughput, invalid and lost rows, CPU usage and the latency from "
+                "arrival to paint. Arguments after -- are passed to the simulator.");
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "Port name or device path to read.", "port");
+    QCommandLineOption simulatorOption("simulator", "Serial simulator to start and read.",
+                                       "path");
+    QCommandLineOption baudOption("baud", "Baud rate.", "baud", "2000000");
+    QCommandLineOption durationOption("duration", "Seconds to read.", "seconds", "10");
+    QCommandLineOption statsOption("stats", "Measures the pipeline stages and writes their "
+                                   "last ticks to file.", "file");
+    QCommandLineOption latencyOption("latency", "Writes the latency histogram to file.",
+                                     "file");
+    parser.addOptions({ portOption, simulatorOption, baudOption, durationOption, statsOption,
+                        latencyOption });
+    parser.addPositionalArgument("arguments", "Arguments of the simulator.", "[-- arguments]");
+    parser.process(app);
+
+    HeadlessDriver::Options options;
+    options.portName = parser.value(portOption);
+    options.simulator = parser.value(simulatorOption);
+    options.simulatorArguments = parser.positionalArguments();
+    options.baudRate = parser.value(baudOption).toInt();
+    options.duration = parser.value(durationOption).toDouble();
+    options.statsFile = parser.value(statsOption);
+    options.latencyFile = parser.value(latencyOption);
+    if (options.portName.isEmpty() == options.simulator.isEmpty())
+        parser.showHelp(1);
+
+    HeadlessDriver driver(options);
+    QObject::connect(&driver, &HeadlessDriver::finished, &app, &QCoreApplication::exit,
+                     Qt::QueuedConnection);
+    driver.start();
+    return app.exec();
+}
@@ -0,0 +1,107 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "serialsimulator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include <signal.h>
+
+namespace {
+
+SerialSimulator *simulator = nullptr;
+
+void stop(int)
+{
+    if (simulator)
+        simulator->stop();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("serialsimulator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+                "Simulates the Arduino board on a pseudo terminal. Prints the "
+                "port to connect to, waits for a line on stdin, streams, and "
+                "prints what it sent when done.");
+    parser.addHelpOption();
+    QCommandLineOption rateOption("rate", "Samples per second.", "rate", "200");
+    QCommandLineOption channelsOption("channels", "Number of channels.", "channels", "4");
+    QCommandLineOption noiseOption("noise", "Standard deviation of the noise.", "noise", "2");
+    QCommandLineOption durationOption("duration", "Seconds to send; 0 until interrupted.",
+                                      "seconds", "0");
+    QCommandLineOption burstOption("burst", "ms between writes.", "ms", "1");
+    QCommandLineOption jitterOption("jitter", "Maximum deviation of a write in ms.", "ms", "0");
+    QCommandLineOption malformedOption("malformed", "Fraction of malformed rows.",
+                                       "fraction", "0");
+    QCommandLineOption noHeaderOption("no-header", "Send no header, like the original board.");
+    QCommandLineOption noWaitOption("no-wait", "Start right away instead of waiting for stdin.");
+    parser.addOptions({ rateOption, channelsOption, noiseOption, durationOption,
+                        burstOption, jitterOption, malformedOption, noHeaderOption,
+                        noWaitOption });
+    parser.process(app);
+
+    SerialSimulator::Options options;
+    options.rate = parser.value(rateOption).toInt();
+    options.channels = parser.value(channelsOption).toInt();
+    options.noise = parser.value(noiseOption).toDouble();
+    options.duration = parser.value(durationOption).toDouble();
+    options.burst = parser.value(burstOption).toInt();
+    options.jitter = parser.value(jitterOption).toInt();
+    options.malformed = parser.value(malformedOption).toDouble();
+    options.header = !parser.isSet(noHeaderOption);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    SerialSimulator serialSimulator(options);
+    if (!serialSimulator.open()) {
+        err << serialSimulator.errorString() << endl;
+        return 1;
+    }
+
+    // Interrupted writes return, so stopping works while the reader lags.
+    simulator = &serialSimulator;
+    struct sigaction action = {};
+    action.sa_handler = stop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // The board only starts sending once the port was opened.
+    out << serialSimulator.portName() << endl;
+    if (!parser.isSet(noWaitOption))
+        QTextStream(stdin).readLine();
+
+    auto success = serialSimulator.run();
+    if (!success)
+        err << serialSimulator.errorString() << endl;
+    out << QString("rows=%1 malformed=%2 bytes=%3 seconds=%4")
+           .arg(serialSimulator.rowsSent())
+           .arg(serialSimulator.malformedSent())
+           .arg(serialSimulator.bytesSent())
+           .arg(serialSimulator.secondsSent()) << endl;
+    return success ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "serialsimulator.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+const char ReadyMessage[] = "Arduino Ready\r\n";
+
+} // namespace
+
+SerialSimulator::SerialSimulator(const Options &options)
+    : _options(options)
+    , _generator(options.rate, options.channels, options.noise)
+{
+
+}
+
+SerialSimulator::~SerialSimulator()
+{
+    if (_slave >= 0)
+        ::close(_slave);
+    if (_master >= 0)
+        ::close(_master);
+}
+
+bool SerialSimulator::open()
+{
+    _master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (_master < 0 || grantpt(_master) != 0 || unlockpt(_master) != 0) {
+        _errorString = QString("Failed to create a pseudo terminal: %1")
+                .arg(strerror(errno));
+        return false;
+    }
+    _portName = QString::fromLocal8Bit(ptsname(_master));
+
+    // The slave stays open as well, so the terminal is raw from the start
+    // and nothing sent while the reader reopens the port is lost.
+    _slave = ::open(ptsname(_master), O_RDWR | O_NOCTTY);
+    termios attributes;
+    if (_slave < 0 || tcgetattr(_slave, &attributes) != 0) {
+        _errorString = QString("Failed to open %1: %2")
+                .arg(_portName).arg(strerror(errno));
+        return false;
+    }
+    cfmakeraw(&attributes);
+    tcsetattr(_slave, TCSANOW, &attributes);
+    return true;
+}
+
+bool SerialSimulator::run()
+{
+    // Like the board after a reset.
+    QByteArray data(ReadyMessage);
+    if (_options.header)
+        data.append(_generator.schema().header()).append("\r\n");
+    if (!write(data))
+        return false;
+
+    auto last = _options.duration > 0.0
+            ? _generator.samples(_options.duration)
+            : std::numeric_limits<qint64>::max();
+    QElapsedTimer clock;
+    clock.start();
+    while (!_stop && static_cast<qint64>(_rows) < last) {
+        // Whatever is due is sent, so late writes catch up at once.
+        auto due = qMin(_generator.samples(clock.nsecsElapsed() / 1e9), last);
+        auto count = static_cast<int>(due - static_cast<qint64>(_rows));
+        if (count > 0) {
+            auto lines = _generator.lines(count);
+            corrupt(lines);
+            if (!write(lines))
+                return false;
+            _rows += static_cast<quint64>(count);
+        }
+
+        auto wait = qMax(1, _options.burst);
+        if (_options.jitter > 0)
+            wait += static_cast<int>(random() % (2 * _options.jitter + 1)) - _options.jitter;
+        QThread::msleep(static_cast<unsigned long>(qMax(0, wait)));
+    }
+    _seconds = clock.nsecsElapsed() / 1e9;
+    return true;
+}
+
+void SerialSimulator::corrupt(QByteArray &lines)
+{
+    if (_options.malformed <= 0.0)
+        return;
+
+    // A byte of the row becomes '#', which no field may contain, so the
+    // reader has to reject the row instead of misreading it.
+    auto threshold = static_cast<quint32>(qMin(_options.malformed, 1.0) * 4294967295.0);
+    auto data = lines.data();
+    int begin = 0;
+    while (begin < lines.size()) {
+        auto end = lines.indexOf('\r', begin);
+        if (end < 0)
+            break;
+        if (end > begin && random() <= threshold) {
+            data[begin + static_cast<int>(random() % static_cast<quint32>(end - begin))] = '#';
+            ++_malformed;
+        }
+        begin = end + 2;
+    }
+}
+
+bool SerialSimulator::write(const QByteArray &data)
+{
+    auto begin = data.constData();
+    auto end = begin + data.size();
+    while (begin < end) {
+        auto written = ::write(_master, begin, static_cast<size_t>(end - begin));
+        if (written < 0) {
+            if (errno == EINTR && !_stop)
+                continue;
+            if (errno == EINTR)
+                return true;
+            _errorString = QString("Failed to write to %1: %2")
+                    .arg(_portName).arg(strerror(errno));
+            return false;
+        }
+        begin += written;
+        _bytes += static_cast<quint64>(written);
+    }
+    return true;
+}
+
+quint32 SerialSimulator::random()
+{
+    _state ^= _state << 13;
+    _state ^= _state >> 17;
+    _state ^= _state << 5;
+    return _state;
+}
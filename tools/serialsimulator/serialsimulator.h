@@ -0,0 +1,141 @@
+/*
+ * Music Psychology Toolbox (MPT) - Chart
+ *
+ * Copyright (c) 2019 - 2020 Alexander Fust
+ * Copyright (c) 2019 - 2020 Christopher Fust
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * This program is free software: you can redistribute it and/or modify
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SERIALSIMULATOR_H
+#define SERIALSIMULATOR_H
+
+#include "../../src/streamgenerator.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+
+/**
+ * @brief Stand-in for the Arduino board on a pseudo terminal.
+ *
+ * The slave side of the terminal is opened like any serial port. Once
+ * run, the simulator sends the handshake and the header like the board
+ * after a reset, then the rows of a StreamGenerator in real time. The
+ * rows can be sent in bursts, with jittered timing and with a fraction of
+ * malformed lines. If the reader falls behind, the terminal's buffer fills
+ * up and the simulator waits, so the rows sent per second are the
+ * sustained throughput of the reader.
+ */
+class SerialSimulator final
+{
+public:
+    struct Options {
+        int rate = 200;
+        int channels = 4;
+        qreal noise = 2.0;
+
+        /**
+         * @brief Seconds to send; forever if 0.
+         */
+        qreal duration = 0.0;
+
+        /**
+         * @brief ms between two writes; the rows due meanwhile are sent at
+         *        once.
+         */
+        int burst = 1;
+
+        /**
+         * @brief Maximum deviation of a write from its time in ms.
+         */
+        int jitter = 0;
+
+        /**
+         * @brief Fraction of rows with a byte replaced by garbage.
+         */
+        qreal malformed = 0.0;
+
+        bool header = true;
+    };
+
+    explicit SerialSimulator(const Options &options);
+    ~SerialSimulator();
+
+    /**
+     * @brief Creates the pseudo terminal.
+     */
+    bool open();
+
+    /**
+     * @brief Path of the slave side, the port to connect to.
+     */
+    QString portName() const {
+        return _portName;
+    }
+
+    QString errorString() const {
+        return _errorString;
+    }
+
+    /**
+     * @brief Sends until the duration is over or stop() is called.
+     */
+    bool run();
+
+    /**
+     * @brief May be called from a signal handler.
+     */
+    void stop() {
+        _stop = true;
+    }
+
+    quint64 rowsSent() const {
+        return _rows;
+    }
+
+    quint64 malformedSent() const {
+        return _malformed;
+    }
+
+    quint64 bytesSent() const {
+        return _bytes;
+    }
+
+    qreal secondsSent() const {
+        return _seconds;
+    }
+
+private:
+    void corrupt(QByteArray &lines);
+    bool write(const QByteArray &data);
+    quint32 random();
+
+    Options _options;
+    StreamGenerator _generator;
+    int _master = -1;
+    int _slave = -1;
+    QString _portName;
+    QString _errorString;
+    std::atomic<bool> _stop{false};
+    quint32 _state = 2463534242u;
+
+    quint64 _rows = 0;
+    quint64 _malformed = 0;
+    quint64 _bytes = 0;
+    qreal _seconds = 0.0;
+};
+
+#endif // SERIALSIMULATOR_H
@@ -0,0 +1,18 @@
+QT -= gui
+
+CONFIG += console c++14
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+HEADERS += \
+    serialsimulator.h \
+    ../../src/channelschema.h \
+    ../../src/sample.h \
+    ../../src/streamgenerator.h
+
+SOURCES += \
+    main.cpp \
+    serialsimulator.cpp \
+    ../../src/channelschema.cpp \
+    ../../src/streamgenerator.cpp
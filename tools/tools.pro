@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    headlessdriver
+
+# The simulator creates a pseudo terminal, which only POSIX systems have.
+unix: SUBDIRS += serialsimulator